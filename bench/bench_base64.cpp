@@ -0,0 +1,79 @@
+#include <benchmark/benchmark.h>
+#include "optimum_p2p/base64.hpp"
+#include <string>
+#include <vector>
+
+namespace optimum_p2p {
+namespace {
+
+std::string MakeEncoded(size_t decoded_size) {
+    static const char alphabet[] =
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    std::string encoded;
+    for (size_t i = 0; i < decoded_size / 3 * 4; i++) {
+        encoded.push_back(alphabet[(i * 7) % 64]);
+    }
+    return encoded;
+}
+
+// Reference: the per-character chars.find() decoder used before
+void LegacyBase64Decode(const std::string& encoded, std::vector<uint8_t>& result) {
+    const std::string chars = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    int val = 0, valb = -8;
+    for (unsigned char c : encoded) {
+        if (c == '=') break;
+        if (chars.find(c) == std::string::npos) continue;
+        val = (val << 6) + chars.find(c);
+        valb += 6;
+        if (valb >= 0) {
+            result.push_back((val >> valb) & 0xFF);
+            valb -= 8;
+        }
+    }
+}
+
+void BM_Base64Decode_Legacy(benchmark::State& state) {
+    std::string encoded = MakeEncoded(state.range(0));
+    std::vector<uint8_t> out;
+    
+    for (auto _ : state) {
+        out.clear();
+        LegacyBase64Decode(encoded, out);
+        benchmark::DoNotOptimize(out.data());
+    }
+    
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(encoded.size()));
+}
+
+// range(1) selects the kernel (Base64Kernel value), range(2) strict mode
+void BM_Base64Decode(benchmark::State& state) {
+    std::string encoded = MakeEncoded(state.range(0));
+    Base64Kernel kernel = static_cast<Base64Kernel>(state.range(1));
+    bool strict = state.range(2) != 0;
+    std::vector<uint8_t> out(Base64DecodedMaxSize(encoded.size()));
+    
+    if (kernel != Base64Kernel::Scalar && static_cast<int>(kernel) > static_cast<int>(Base64ActiveKernel())) {
+        state.SkipWithError("kernel not supported by this CPU");
+        return;
+    }
+    
+    for (auto _ : state) {
+        Base64Result result = Base64Decode(encoded, out.data(), strict, kernel);
+        benchmark::DoNotOptimize(result);
+    }
+    
+    state.SetLabel(Base64KernelName(kernel));
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(encoded.size()));
+}
+
+// Decoded sizes: 96 B, 4 KiB, 1 MiB
+BENCHMARK(BM_Base64Decode_Legacy)->Arg(96)->Arg(4 << 10)->Arg(1 << 20);
+BENCHMARK(BM_Base64Decode)->ArgsProduct({
+    {96, 4 << 10, 1 << 20},
+    {static_cast<int>(Base64Kernel::Scalar), static_cast<int>(Base64Kernel::SSE41),
+     static_cast<int>(Base64Kernel::AVX2)},
+    {0, 1}
+});
+
+} // namespace
+} // namespace optimum_p2p
@@ -0,0 +1,153 @@
+#include <benchmark/benchmark.h>
+#include "optimum_p2p/utils.hpp"
+#include "optimum_p2p/types.hpp"
+#include <nlohmann/json.hpp>
+#include <string>
+#include <vector>
+#include <cctype>
+
+namespace optimum_p2p {
+namespace {
+
+// Envelope as sent by the node. Go's encoding/json emits []byte as base64,
+// so range(1) == 1 selects a base64 payload and 0 a plain string payload.
+std::string MakeEnvelope(size_t payload_size, bool base64) {
+    std::string payload;
+    if (base64) {
+        static const char alphabet[] =
+            "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+        size_t encoded_size = (payload_size + 2) / 3 * 4;
+        for (size_t i = 0; i < encoded_size; i++) {
+            payload.push_back(alphabet[(i * 7) % 64]);
+        }
+    } else {
+        for (size_t i = 0; i < payload_size; i++) {
+            payload.push_back(static_cast<char>('a' + i % 26));
+        }
+        payload[0] = ' ';
+    }
+    
+    nlohmann::json j;
+    j["MessageID"] = "3b4f0c1e9a8d7f6e5d4c3b2a19081726";
+    j["Topic"] = "benchmark-topic";
+    j["Message"] = payload;
+    j["SourceNodeID"] = "12D3KooWEyoppNCUx8Yx66oV9fJnriXwCcXwDDUA2kj6vnc6iDEp";
+    return j.dump();
+}
+
+// Reference: the DOM-based parser ParseMessage used before the envelope scanner
+std::vector<uint8_t> LegacyBase64Decode(const std::string& encoded) {
+    const std::string chars = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    std::vector<uint8_t> result;
+    int val = 0, valb = -8;
+    for (unsigned char c : encoded) {
+        if (c == '=') break;
+        if (chars.find(c) == std::string::npos) continue;
+        val = (val << 6) + chars.find(c);
+        valb += 6;
+        if (valb >= 0) {
+            result.push_back((val >> valb) & 0xFF);
+            valb -= 8;
+        }
+    }
+    return result;
+}
+
+P2PMessage LegacyParseMessage(const std::vector<uint8_t>& json_data) {
+    P2PMessage msg;
+    try {
+        std::string json_str(json_data.begin(), json_data.end());
+        nlohmann::json j = nlohmann::json::parse(json_str);
+        if (j.contains("MessageID")) {
+            msg.message_id = j["MessageID"].get<std::string>();
+        }
+        if (j.contains("Topic")) {
+            msg.topic = j["Topic"].get<std::string>();
+        }
+        if (j.contains("SourceNodeID")) {
+            msg.source_node_id = j["SourceNodeID"].get<std::string>();
+        }
+        if (j.contains("Message") && j["Message"].is_string()) {
+            std::string message_str = j["Message"].get<std::string>();
+            bool try_base64 = false;
+            if (!message_str.empty()) {
+                bool all_base64_chars = true;
+                for (char c : message_str) {
+                    if (!std::isalnum(c) && c != '+' && c != '/' && c != '=') {
+                        all_base64_chars = false;
+                        break;
+                    }
+                }
+                if (all_base64_chars && (message_str.find('=') != std::string::npos ||
+                    (message_str.find('+') != std::string::npos || message_str.find('/') != std::string::npos) ||
+                    message_str.length() % 4 == 0)) {
+                    try_base64 = true;
+                }
+            }
+            if (try_base64) {
+                std::vector<uint8_t> decoded = LegacyBase64Decode(message_str);
+                if (!decoded.empty() && decoded.size() < message_str.size()) {
+                    msg.message = decoded;
+                } else {
+                    msg.message.assign(message_str.begin(), message_str.end());
+                }
+            } else {
+                msg.message.assign(message_str.begin(), message_str.end());
+            }
+        }
+    } catch (const nlohmann::json::exception&) {
+    }
+    return msg;
+}
+
+void SetCounters(benchmark::State& state, size_t bytes) {
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(bytes));
+}
+
+void BM_ParseMessage_LegacyDOM(benchmark::State& state) {
+    std::string envelope = MakeEnvelope(state.range(0), state.range(1) != 0);
+    std::vector<uint8_t> data(envelope.begin(), envelope.end());
+    
+    for (auto _ : state) {
+        P2PMessage msg = LegacyParseMessage(data);
+        benchmark::DoNotOptimize(msg);
+    }
+    
+    SetCounters(state, data.size());
+}
+
+void BM_ParseMessage(benchmark::State& state) {
+    std::string envelope = MakeEnvelope(state.range(0), state.range(1) != 0);
+    std::vector<uint8_t> data(envelope.begin(), envelope.end());
+    
+    for (auto _ : state) {
+        P2PMessage msg = ParseMessage(data);
+        benchmark::DoNotOptimize(msg);
+    }
+    
+    SetCounters(state, data.size());
+}
+
+void BM_MessageDecoder_View(benchmark::State& state) {
+    std::string envelope = MakeEnvelope(state.range(0), state.range(1) != 0);
+    MessageDecoder decoder;
+    P2PMessageView view;
+    
+    for (auto _ : state) {
+        decoder.Decode(envelope, view);
+        benchmark::DoNotOptimize(view);
+    }
+    
+    SetCounters(state, envelope.size());
+}
+
+// Payload sizes: 100 B, 4 KiB, 1 MiB; plain and base64 payloads
+#define ENVELOPE_ARGS ArgsProduct({{100, 4 << 10, 1 << 20}, {0, 1}})
+
+BENCHMARK(BM_ParseMessage_LegacyDOM)->ENVELOPE_ARGS;
+BENCHMARK(BM_ParseMessage)->ENVELOPE_ARGS;
+BENCHMARK(BM_MessageDecoder_View)->ENVELOPE_ARGS;
+
+} // namespace
+} // namespace optimum_p2p
@@ -0,0 +1,197 @@
+#include <benchmark/benchmark.h>
+#include "p2p_stream.pb.h"
+#include "proxy_stream.pb.h"
+#include <google/protobuf/arena.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+
+// Count every heap allocation made by the process so the benchmarks can report
+// allocations per message next to the timings. Every replaceable new and
+// delete goes through malloc/free so the forms always match.
+static std::atomic<size_t> g_allocations{0};
+
+static void* CountedAlloc(size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+static void* CountedAlloc(size_t size, std::align_val_t align) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    size_t alignment = std::max(static_cast<size_t>(align), sizeof(void*));
+    void* p = nullptr;
+    if (posix_memalign(&p, alignment, size ? size : 1) == 0) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new(size_t size) {
+    return CountedAlloc(size);
+}
+
+void* operator new[](size_t size) {
+    return CountedAlloc(size);
+}
+
+void* operator new(size_t size, std::align_val_t align) {
+    return CountedAlloc(size, align);
+}
+
+void* operator new[](size_t size, std::align_val_t align) {
+    return CountedAlloc(size, align);
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p, size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::align_val_t) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, size_t, std::align_val_t) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p, std::align_val_t) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p, size_t, std::align_val_t) noexcept {
+    std::free(p);
+}
+
+namespace optimum_p2p {
+namespace {
+
+const std::string kTopic = "optimum-benchmark-topic";
+
+// The same retention limit the clients use before rebuilding a reused message
+constexpr size_t kMaxRetainedBytes = 1024 * 1024;
+
+std::string MakePayload(size_t size) {
+    std::string payload;
+    for (size_t i = 0; i < size; i++) {
+        payload.push_back(static_cast<char>('a' + i % 26));
+    }
+    return payload;
+}
+
+void SetCounters(benchmark::State& state, size_t allocations) {
+    state.SetItemsProcessed(state.iterations());
+    state.counters["allocs/msg"] = benchmark::Counter(
+        static_cast<double>(allocations), benchmark::Counter::kAvgIterations);
+}
+
+// Before: a fresh Request per Publish/Subscribe call
+void BM_Request_PerMessage(benchmark::State& state) {
+    std::string payload = MakePayload(state.range(0));
+    std::string wire;
+    
+    size_t before = g_allocations.load();
+    for (auto _ : state) {
+        proto::Request request;
+        request.set_command(2);
+        request.set_topic(kTopic);
+        request.set_data(payload);
+        request.SerializeToString(&wire);
+        benchmark::DoNotOptimize(wire.data());
+    }
+    
+    SetCounters(state, g_allocations.load() - before);
+}
+
+// After: one arena-allocated Request refilled for every write
+void BM_Request_ArenaReused(benchmark::State& state) {
+    std::string payload = MakePayload(state.range(0));
+    std::string wire;
+    google::protobuf::Arena arena;
+    proto::Request* request = nullptr;
+    
+    size_t before = g_allocations.load();
+    for (auto _ : state) {
+        if (request && request->data().capacity() > kMaxRetainedBytes) {
+            request = nullptr;
+            arena.Reset();
+        }
+        if (!request) {
+            request = google::protobuf::Arena::CreateMessage<proto::Request>(&arena);
+        }
+        request->set_command(2);
+        request->set_topic(kTopic);
+        request->set_data(payload);
+        request->SerializeToString(&wire);
+        benchmark::DoNotOptimize(wire.data());
+    }
+    
+    SetCounters(state, g_allocations.load() - before);
+}
+
+std::string MakeProxyWire(size_t size) {
+    proto::ProxyMessage msg;
+    msg.set_client_id("client_0a1b2c3d");
+    msg.set_message(MakePayload(size));
+    msg.set_topic(kTopic);
+    msg.set_message_id("3b4f0c1e9a8d7f6e5d4c3b2a19081726");
+    msg.set_type("message");
+    return msg.SerializeAsString();
+}
+
+// Before: a fresh ProxyMessage per ReceiveMessage call
+void BM_ProxyMessage_PerRead(benchmark::State& state) {
+    std::string wire = MakeProxyWire(state.range(0));
+    
+    size_t before = g_allocations.load();
+    for (auto _ : state) {
+        proto::ProxyMessage msg;
+        msg.ParseFromString(wire);
+        benchmark::DoNotOptimize(msg.message().data());
+    }
+    
+    SetCounters(state, g_allocations.load() - before);
+}
+
+// After: one arena-allocated ProxyMessage parsed into on every read
+void BM_ProxyMessage_ArenaReused(benchmark::State& state) {
+    std::string wire = MakeProxyWire(state.range(0));
+    google::protobuf::Arena arena;
+    proto::ProxyMessage* msg = google::protobuf::Arena::CreateMessage<proto::ProxyMessage>(&arena);
+    
+    size_t before = g_allocations.load();
+    for (auto _ : state) {
+        msg->ParseFromString(wire);
+        benchmark::DoNotOptimize(msg->message().data());
+    }
+    
+    SetCounters(state, g_allocations.load() - before);
+}
+
+// Payload sizes: 64 B, 4 KiB, 256 KiB
+#define PAYLOAD_ARGS Arg(64)->Arg(4 << 10)->Arg(256 << 10)
+
+BENCHMARK(BM_Request_PerMessage)->PAYLOAD_ARGS;
+BENCHMARK(BM_Request_ArenaReused)->PAYLOAD_ARGS;
+BENCHMARK(BM_ProxyMessage_PerRead)->PAYLOAD_ARGS;
+BENCHMARK(BM_ProxyMessage_ArenaReused)->PAYLOAD_ARGS;
+
+} // namespace
+} // namespace optimum_p2p
@@ -0,0 +1,116 @@
+#include <benchmark/benchmark.h>
+#include "fake_proxy.hpp"
+#include "optimum_p2p/proxy_client.hpp"
+#include <curl/curl.h>
+#include <nlohmann/json.hpp>
+#include <atomic>
+#include <memory>
+#include <string>
+
+namespace optimum_p2p {
+namespace {
+
+// One fake proxy for all cases and threads
+fake::FakeProxy& Proxy() {
+    static fake::FakeProxy* proxy = []() {
+        auto* started = new fake::FakeProxy();
+        started->Start();
+        return started;
+    }();
+    return *proxy;
+}
+
+size_t DiscardResponse(void*, size_t size, size_t nmemb, void*) {
+    return size * nmemb;
+}
+
+// A REST publish as ProxyClient made it before handles were pooled: a new
+// easy handle, and so a new TCP connection, per request
+bool PublishWithFreshHandle(const std::string& url, const std::string& payload) {
+    CURL* curl = curl_easy_init();
+    if (!curl) {
+        return false;
+    }
+    
+    struct curl_slist* headers = curl_slist_append(nullptr, "Content-Type: application/json");
+    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+    curl_easy_setopt(curl, CURLOPT_POSTFIELDS, payload.c_str());
+    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, DiscardResponse);
+    
+    CURLcode res = curl_easy_perform(curl);
+    long response_code = 0;
+    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &response_code);
+    
+    curl_slist_free_all(headers);
+    curl_easy_cleanup(curl);
+    return res == CURLE_OK && response_code == 200;
+}
+
+// Baseline: connect per publish. range(0): message bytes.
+void BM_ProxyPublish_FreshHandle(benchmark::State& state) {
+    nlohmann::json body;
+    body["client_id"] = "bench";
+    body["topic"] = "bench-topic";
+    body["message"] = std::string(state.range(0), 'x');
+    std::string payload = body.dump();
+    std::string url = Proxy().RestUrl() + "/api/v1/publish";
+    
+    for (auto _ : state) {
+        if (!PublishWithFreshHandle(url, payload)) {
+            state.SkipWithError("publish failed");
+            break;
+        }
+    }
+    
+    state.SetItemsProcessed(state.iterations());
+}
+
+// ProxyClient::Publish with pooled handles and kept-alive connections; with
+// several threads they share one client
+void BM_ProxyPublish_Pooled(benchmark::State& state) {
+    static std::unique_ptr<ProxyClient> client;
+    if (state.thread_index() == 0) {
+        client = std::make_unique<ProxyClient>(Proxy().RestUrl(), Proxy().GrpcAddress());
+    }
+    std::string message(state.range(0), 'x');
+    
+    for (auto _ : state) {
+        if (!client->Publish("bench", "bench-topic", message)) {
+            state.SkipWithError("publish failed");
+            break;
+        }
+    }
+    
+    state.SetItemsProcessed(state.iterations());
+}
+
+// ProxyClient::PublishAsync from one thread. range(0): message bytes,
+// range(1): max in flight.
+void BM_ProxyPublish_Async(benchmark::State& state) {
+    ProxyClient client(Proxy().RestUrl(), Proxy().GrpcAddress());
+    client.SetMaxInFlight(state.range(1));
+    std::string message(state.range(0), 'x');
+    std::atomic<int64_t> failures{0};
+    
+    for (auto _ : state) {
+        client.PublishAsync("bench", "bench-topic", message, [&failures](bool ok) {
+            if (!ok) {
+                failures++;
+            }
+        });
+    }
+    client.WaitAsync();
+    
+    if (failures > 0) {
+        state.SkipWithError("publish failed");
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_ProxyPublish_FreshHandle)->Arg(256)->Arg(4 << 10)->UseRealTime();
+BENCHMARK(BM_ProxyPublish_Pooled)->Arg(256)->Arg(4 << 10)->ThreadRange(1, 4)->UseRealTime();
+BENCHMARK(BM_ProxyPublish_Async)->ArgsProduct({{256, 4 << 10}, {1, 16, 64}})->UseRealTime();
+
+} // namespace
+} // namespace optimum_p2p
@@ -0,0 +1,105 @@
+#include <benchmark/benchmark.h>
+#include "optimum_p2p/client.hpp"
+#include "fake_node.hpp"
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace optimum_p2p {
+namespace {
+
+enum PublishMode { kPublish = 0, kPublishAsync = 1, kPublishBatch = 2 };
+
+constexpr int kMessagesPerIteration = 1000;
+
+// Publish kMessagesPerIteration messages and wait until the subscriber has
+// received all of them. range(0): payload bytes, range(1): PublishMode,
+// range(2): 1 drives the subscriber with an AsyncEngine instead of a thread
+void BM_PublishReceive(benchmark::State& state) {
+    fake::FakeNode node;
+    if (!node.Start()) {
+        state.SkipWithError("fake node failed to start");
+        return;
+    }
+    
+    size_t payload_size = state.range(0);
+    auto mode = static_cast<PublishMode>(state.range(1));
+    
+    std::shared_ptr<AsyncEngine> engine = state.range(2) ? std::make_shared<AsyncEngine>(1) : nullptr;
+    auto subscriber = engine ? std::make_unique<P2PClient>(node.Address(), engine)
+                             : std::make_unique<P2PClient>(node.Address());
+    
+    std::mutex mutex;
+    std::condition_variable all_received;
+    int received = 0;
+    subscriber->SetMessageViewCallback([&](const P2PMessageView&) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (++received == kMessagesPerIteration) {
+            all_received.notify_one();
+        }
+    });
+    
+    const std::string topic = "bench-topic";
+    if (!subscriber->Subscribe(topic)) {
+        state.SkipWithError("subscribe failed");
+        return;
+    }
+    
+    P2PClient publisher(node.Address());
+    std::vector<uint8_t> payload(payload_size, 'x');
+    std::vector<std::vector<uint8_t>> batch(kMessagesPerIteration, payload);
+    
+    if (!node.WaitForSubscribers(topic, 1, std::chrono::seconds(5))) {
+        state.SkipWithError("subscription did not reach the node");
+        return;
+    }
+    
+    for (auto _ : state) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            received = 0;
+        }
+        
+        if (mode == kPublishBatch) {
+            publisher.PublishBatch(topic, batch);
+        } else if (mode == kPublishAsync) {
+            std::vector<std::future<bool>> results;
+            results.reserve(kMessagesPerIteration);
+            for (int i = 0; i < kMessagesPerIteration; i++) {
+                results.push_back(publisher.PublishAsync(topic, payload));
+            }
+            for (auto& result : results) {
+                result.get();
+            }
+        } else {
+            for (int i = 0; i < kMessagesPerIteration; i++) {
+                publisher.Publish(topic, payload);
+            }
+        }
+        
+        std::unique_lock<std::mutex> lock(mutex);
+        if (!all_received.wait_for(lock, std::chrono::seconds(30),
+                                   [&]() { return received >= kMessagesPerIteration; })) {
+            state.SkipWithError("timed out waiting for messages");
+            break;
+        }
+    }
+    
+    state.SetItemsProcessed(state.iterations() * kMessagesPerIteration);
+    state.SetBytesProcessed(state.iterations() * kMessagesPerIteration * payload_size);
+    
+    publisher.Shutdown();
+    subscriber->Shutdown();
+    node.Stop();
+}
+
+BENCHMARK(BM_PublishReceive)
+    ->ArgNames({"payload", "mode", "async"})
+    ->ArgsProduct({{256, 4 << 10}, {kPublish, kPublishAsync, kPublishBatch}, {0, 1}})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+} // namespace
+} // namespace optimum_p2p
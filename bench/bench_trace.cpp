@@ -0,0 +1,161 @@
+#include <benchmark/benchmark.h>
+#include "optimum_p2p/gossipsub_trace.hpp"
+#include "optimum_p2p/mump2p_trace.hpp"
+#include "optimum_p2p/utils.hpp"
+#include "trace.pb.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace optimum_p2p {
+namespace {
+
+using pubsub::pb::TraceEvent;
+
+constexpr int kNodes = 32;
+constexpr int kTopics = 8;
+
+std::string PeerID(int node) {
+    // 38-byte identity multihash, like an Ed25519 libp2p peer ID
+    std::string id = "\x00\x24\x08\x01\x12\x20";
+    id.resize(38, static_cast<char>(node));
+    return id;
+}
+
+// A firehose as seen from a fleet: every message is published once, then
+// delivered, forwarded and duplicated on every node
+std::vector<std::string> MakeTraceStream(size_t messages) {
+    std::vector<std::string> stream;
+    TraceEvent event;
+    int64_t now = 1700000000000000000;
+    
+    for (size_t m = 0; m < messages; m++) {
+        std::string message_id = PeerID(int(m % kNodes)) + std::to_string(m);
+        std::string topic = "topic-" + std::to_string(m % kTopics);
+        
+        event.Clear();
+        event.set_type(TraceEvent::PUBLISH_MESSAGE);
+        event.set_peerid(PeerID(int(m % kNodes)));
+        event.set_timestamp(now);
+        event.mutable_publishmessage()->set_messageid(message_id);
+        event.mutable_publishmessage()->set_topic(topic);
+        stream.push_back(event.SerializeAsString());
+        
+        for (int node = 0; node < kNodes; node++) {
+            event.Clear();
+            event.set_type(TraceEvent::DELIVER_MESSAGE);
+            event.set_peerid(PeerID(node));
+            event.set_timestamp(now + 1000000 + node * 50000);
+            event.mutable_delivermessage()->set_messageid(message_id);
+            event.mutable_delivermessage()->set_topic(topic);
+            event.mutable_delivermessage()->set_receivedfrom(PeerID((node + 1) % kNodes));
+            stream.push_back(event.SerializeAsString());
+            
+            event.Clear();
+            event.set_type(TraceEvent::SEND_RPC);
+            event.set_peerid(PeerID(node));
+            event.set_timestamp(now + 1100000 + node * 50000);
+            auto* meta = event.mutable_sendrpc()->mutable_meta()->add_messages();
+            meta->set_messageid(message_id);
+            meta->set_topic(topic);
+            stream.push_back(event.SerializeAsString());
+            
+            event.Clear();
+            event.set_type(TraceEvent::DUPLICATE_MESSAGE);
+            event.set_peerid(PeerID(node));
+            event.set_timestamp(now + 1200000 + node * 50000);
+            event.mutable_duplicatemessage()->set_messageid(message_id);
+            event.mutable_duplicatemessage()->set_topic(topic);
+            event.mutable_duplicatemessage()->set_receivedfrom(PeerID((node + 2) % kNodes));
+            stream.push_back(event.SerializeAsString());
+        }
+        now += 10000000;
+    }
+    
+    return stream;
+}
+
+const std::vector<std::string>& TraceStream() {
+    static const std::vector<std::string> stream = MakeTraceStream(256);
+    return stream;
+}
+
+void SetCounters(benchmark::State& state, const std::vector<std::string>& stream) {
+    size_t bytes = 0;
+    for (const auto& event : stream) {
+        bytes += event.size();
+    }
+    state.SetItemsProcessed(state.iterations() * stream.size());
+    state.SetBytesProcessed(state.iterations() * bytes);
+}
+
+// Decode + aggregate; with Threads(n) the aggregator is shared, as when one
+// aggregator is fed by the receive threads of many clients
+void BM_Aggregator_Add(benchmark::State& state) {
+    static std::shared_ptr<GossipSubTraceAggregator> aggregator;
+    if (state.thread_index() == 0) {
+        aggregator = std::make_shared<GossipSubTraceAggregator>();
+    }
+    const auto& stream = TraceStream();
+    
+    for (auto _ : state) {
+        for (const auto& event : stream) {
+            aggregator->Add(event);
+        }
+    }
+    
+    SetCounters(state, stream);
+}
+
+// mump2p propagation tracking over the same stream (zero-copy wire decoder)
+void BM_PropagationTracker_Add(benchmark::State& state) {
+    const auto& stream = TraceStream();
+    
+    for (auto _ : state) {
+        state.PauseTiming();
+        PropagationTracker tracker(kNodes);
+        state.ResumeTiming();
+        for (const auto& event : stream) {
+            tracker.Add(event);
+        }
+    }
+    
+    SetCounters(state, stream);
+}
+
+// Decode + trace file line formatting (peer IDs to base58, message ID to hex)
+void BM_FormatTraceLine(benchmark::State& state) {
+    const auto& stream = TraceStream();
+    size_t total = 0;
+    auto callback = [&total](const std::string& line) { total += line.size(); };
+    
+    for (auto _ : state) {
+        for (const auto& event : stream) {
+            HandleGossipSubTrace(std::string_view(event), true, callback);
+        }
+    }
+    
+    benchmark::DoNotOptimize(total);
+    SetCounters(state, stream);
+}
+
+// Querying while traces arrive
+void BM_Aggregator_GetTopicStats(benchmark::State& state) {
+    GossipSubTraceAggregator aggregator;
+    for (const auto& event : TraceStream()) {
+        aggregator.Add(event);
+    }
+    
+    for (auto _ : state) {
+        auto stats = aggregator.GetTopicStats();
+        benchmark::DoNotOptimize(stats.size());
+    }
+}
+
+BENCHMARK(BM_Aggregator_Add)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK(BM_PropagationTracker_Add);
+BENCHMARK(BM_FormatTraceLine);
+BENCHMARK(BM_Aggregator_GetTopicStats);
+
+} // namespace
+} // namespace optimum_p2p
@@ -0,0 +1,147 @@
+#include <benchmark/benchmark.h>
+#include "optimum_p2p/payload_generator.hpp"
+#include "optimum_p2p/utils.hpp"
+#include <chrono>
+#include <array>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace optimum_p2p {
+namespace {
+
+std::vector<uint8_t> MakeData(size_t size) {
+    std::vector<uint8_t> data(size);
+    for (size_t i = 0; i < size; i++) {
+        data[i] = static_cast<uint8_t>(i * 31 + 7);
+    }
+    return data;
+}
+
+// String-returning SHA256Hex (one allocation per call)
+void BM_SHA256Hex(benchmark::State& state) {
+    std::vector<uint8_t> data = MakeData(state.range(0));
+    
+    for (auto _ : state) {
+        std::string hex = SHA256Hex(data);
+        benchmark::DoNotOptimize(hex.data());
+    }
+    
+    state.SetBytesProcessed(state.iterations() * data.size());
+}
+
+// Non-allocating SHA256Hex into a caller buffer
+void BM_SHA256Hex_Array(benchmark::State& state) {
+    std::vector<uint8_t> data = MakeData(state.range(0));
+    std::array<char, 64> hex;
+    
+    for (auto _ : state) {
+        SHA256Hex(data.data(), data.size(), hex);
+        benchmark::DoNotOptimize(hex.data());
+    }
+    
+    state.SetBytesProcessed(state.iterations() * data.size());
+}
+
+void BM_HeadHex(benchmark::State& state) {
+    std::vector<uint8_t> data = MakeData(4096);
+    size_t n = state.range(0);
+    
+    for (auto _ : state) {
+        std::string hex = HeadHex(data, n);
+        benchmark::DoNotOptimize(hex.data());
+    }
+    
+    state.SetBytesProcessed(state.iterations() * n);
+}
+
+// IP list of range(0) entries with comments and blank lines mixed in
+void BM_ReadIPsFromFile(benchmark::State& state) {
+    std::string filename = "/tmp/optimum_p2p_bench_ips_" + std::to_string(state.range(0)) + ".txt";
+    {
+        std::ofstream file(filename);
+        file << "# benchmark node list\n";
+        for (int64_t i = 0; i < state.range(0); i++) {
+            file << "  10.0." << (i / 250) << "." << (i % 250 + 1) << ":33221\n";
+            if (i % 10 == 0) {
+                file << "\n# rack " << i / 10 << "\n";
+            }
+        }
+    }
+    
+    for (auto _ : state) {
+        std::vector<std::string> ips = ReadIPsFromFile(filename);
+        benchmark::DoNotOptimize(ips.data());
+    }
+    
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    std::remove(filename.c_str());
+}
+
+// Multi-message payload as PublishToNode built it before PayloadGenerator:
+// a fresh random_device and mt19937 per message, HeadHex and to_string
+void BM_PayloadLegacy(benchmark::State& state) {
+    int i = 0;
+    for (auto _ : state) {
+        std::random_device rd;
+        std::mt19937 gen(rd());
+        std::uniform_int_distribution<> dis(0, 255);
+        
+        std::vector<uint8_t> random_bytes(4);
+        for (auto& b : random_bytes) {
+            b = static_cast<uint8_t>(dis(gen));
+        }
+        
+        std::string hex_suffix = HeadHex(random_bytes, 4);
+        auto now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        std::string msg = "[" + std::to_string(now) + " " + std::to_string(hex_suffix.length()) +
+                          "] " + std::to_string(++i) + " - " + hex_suffix + " XXX";
+        std::vector<uint8_t> message_data(msg.begin(), msg.end());
+        benchmark::DoNotOptimize(message_data.data());
+    }
+    
+    state.SetItemsProcessed(state.iterations());
+}
+
+// DefaultPayloadGenerator, same format, reusing the output buffer
+void BM_PayloadDefault(benchmark::State& state) {
+    DefaultPayloadGenerator generator;
+    std::vector<uint8_t> data;
+    std::vector<uint8_t> out;
+    int i = 0;
+    
+    for (auto _ : state) {
+        generator.Generate(data, i++, 1000, out);
+        benchmark::DoNotOptimize(out.data());
+    }
+    
+    state.SetItemsProcessed(state.iterations());
+}
+
+// Timestamp prefix plus range(0) random bytes
+void BM_PayloadRandom(benchmark::State& state) {
+    RandomPayloadGenerator generator(state.range(0));
+    std::vector<uint8_t> out;
+    
+    for (auto _ : state) {
+        generator.Generate({}, 0, 1, out);
+        benchmark::DoNotOptimize(out.data());
+    }
+    
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_SHA256Hex)->Arg(64)->Arg(4 << 10)->Arg(1 << 20);
+BENCHMARK(BM_SHA256Hex_Array)->Arg(64)->Arg(4 << 10)->Arg(1 << 20);
+BENCHMARK(BM_HeadHex)->Arg(8)->Arg(64)->Arg(4096);
+BENCHMARK(BM_ReadIPsFromFile)->Arg(10)->Arg(1000);
+BENCHMARK(BM_PayloadLegacy);
+BENCHMARK(BM_PayloadDefault);
+BENCHMARK(BM_PayloadRandom)->Arg(256)->Arg(4 << 10);
+
+} // namespace
+} // namespace optimum_p2p
@@ -0,0 +1,139 @@
+// Open-loop load generator: publish to one or more nodes at a target rate
+//
+//   load_generator --addr 127.0.0.1:33221,127.0.0.1:33222 --topic demo
+//                  --rate 1000 --duration 30 [--poisson] [--ramp 10 --start-rate 0]
+//
+// Prints a per-node summary every --report seconds and at the end.
+
+#include "optimum_p2p/load_generator.hpp"
+#include "optimum_p2p/payload_generator.hpp"
+#include "optimum_p2p/utils.hpp"
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace optimum_p2p;
+
+static std::atomic<bool> g_interrupted(false);
+
+static void HandleSignal(int) {
+    g_interrupted = true;
+}
+
+static void PrintUsage(const char* program) {
+    std::cerr << "usage: " << program << " (--addr host:port[,host:port...] | --ipfile file) [options]\n"
+              << "  --topic name        topic to publish on (default load-test)\n"
+              << "  --rate n            target messages per second per node (default 100)\n"
+              << "  --start-rate n      rate at the start of the ramp (default 0)\n"
+              << "  --ramp seconds      ramp linearly from --start-rate to --rate (default 0)\n"
+              << "  --duration seconds  run time, 0 until interrupted (default 10)\n"
+              << "  --poisson           Poisson arrivals instead of evenly spaced messages\n"
+              << "  --size bytes        payload bytes after the timestamp prefix (default 256)\n"
+              << "  --random            random payload bytes instead of filler\n"
+              << "  --seed n            seed for Poisson arrivals (default 1)\n"
+              << "  --output file       log address, size and SHA256 of every message\n"
+              << "  --report seconds    print the summary this often, 0 only at the end (default 5)\n";
+}
+
+int main(int argc, char* argv[]) {
+    std::vector<std::string> addresses;
+    std::string topic = "load-test";
+    std::string output;
+    double report_seconds = 5;
+    bool random_payloads = false;
+    LoadProfile profile;
+    profile.duration = std::chrono::seconds(10);
+    
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        auto value = [&]() -> std::string {
+            if (i + 1 >= argc) {
+                std::cerr << "missing value for " << arg << "\n";
+                std::exit(2);
+            }
+            return argv[++i];
+        };
+        auto seconds = [](const std::string& text) {
+            return std::chrono::milliseconds(static_cast<int64_t>(std::atof(text.c_str()) * 1000));
+        };
+        
+        if (arg == "--addr") {
+            std::stringstream list(value());
+            std::string address;
+            while (std::getline(list, address, ',')) {
+                if (!address.empty()) {
+                    addresses.push_back(address);
+                }
+            }
+        } else if (arg == "--ipfile") {
+            for (const auto& address : ReadIPsFromFile(value())) {
+                addresses.push_back(address);
+            }
+        } else if (arg == "--topic") {
+            topic = value();
+        } else if (arg == "--rate") {
+            profile.rate = std::atof(value().c_str());
+        } else if (arg == "--start-rate") {
+            profile.start_rate = std::atof(value().c_str());
+        } else if (arg == "--ramp") {
+            profile.ramp = seconds(value());
+        } else if (arg == "--duration") {
+            profile.duration = seconds(value());
+        } else if (arg == "--poisson") {
+            profile.arrivals = ArrivalProcess::Poisson;
+        } else if (arg == "--size") {
+            profile.payload_size = std::strtoull(value().c_str(), nullptr, 10);
+        } else if (arg == "--random") {
+            random_payloads = true;
+        } else if (arg == "--seed") {
+            profile.seed = static_cast<uint32_t>(std::strtoul(value().c_str(), nullptr, 10));
+        } else if (arg == "--output") {
+            output = value();
+        } else if (arg == "--report") {
+            report_seconds = std::atof(value().c_str());
+        } else {
+            PrintUsage(argv[0]);
+            return arg == "--help" || arg == "-h" ? 0 : 2;
+        }
+    }
+    
+    if (addresses.empty()) {
+        PrintUsage(argv[0]);
+        return 2;
+    }
+    
+    LoadGenerator generator(addresses);
+    generator.SetOutputFile(output);
+    if (random_payloads) {
+        generator.SetPayloadGenerator(std::make_shared<RandomPayloadGenerator>(profile.payload_size));
+    }
+    if (!generator.Start(topic, profile)) {
+        std::cerr << "nothing to send: --rate (or --start-rate with --ramp) must be positive\n";
+        return 2;
+    }
+    
+    std::signal(SIGINT, HandleSignal);
+    std::signal(SIGTERM, HandleSignal);
+    
+    auto next_report = std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(report_seconds));
+    while (generator.Running() && !g_interrupted) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        if (report_seconds > 0 && std::chrono::steady_clock::now() >= next_report) {
+            std::cout << generator.Summary() << std::endl;
+            next_report += std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                std::chrono::duration<double>(report_seconds));
+        }
+    }
+    generator.Stop();
+    
+    std::cout << generator.Summary();
+    return generator.GetTotal().failed > 0 ? 1 : 0;
+}
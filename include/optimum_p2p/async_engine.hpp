@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <atomic>
+
+#include <grpcpp/grpcpp.h>
+
+namespace optimum_p2p {
+
+// AsyncEngine multiplexes many async-mode P2PClient streams onto a small
+// pool of poller threads. Each thread drains its own grpc::CompletionQueue;
+// streams are assigned to queues round-robin.
+//
+// The engine must outlive every client using it (clients hold a shared_ptr);
+// its poller threads stop when the last reference goes away.
+class AsyncEngine {
+public:
+    // Completion-queue tag. OnComplete runs on a poller thread.
+    class Operation {
+    public:
+        virtual ~Operation() = default;
+        virtual void OnComplete(bool ok) = 0;
+    };
+    
+    // num_threads == 0 uses std::thread::hardware_concurrency()
+    explicit AsyncEngine(size_t num_threads = 0);
+    ~AsyncEngine();
+    
+    AsyncEngine(const AsyncEngine&) = delete;
+    AsyncEngine& operator=(const AsyncEngine&) = delete;
+    
+    // Completion queue for a new stream
+    grpc::CompletionQueue* NextQueue();
+    
+    size_t NumThreads() const { return threads_.size(); }
+
+private:
+    // Shut down all completion queues and join poller threads. Only the
+    // destructor calls this: while a client's stream is registered its
+    // queue never drains and the join would hang.
+    void Shutdown();
+    
+    static void PollLoop(grpc::CompletionQueue* cq);
+    
+    std::vector<std::unique_ptr<grpc::CompletionQueue>> queues_;
+    std::vector<std::thread> threads_;
+    std::atomic<size_t> next_queue_;
+    std::atomic<bool> running_;
+};
+
+} // namespace optimum_p2p
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace optimum_p2p {
+
+// Base64Status reports the outcome of a decode
+enum class Base64Status {
+    Ok = 0,
+    InvalidCharacter = 1, // byte outside the standard alphabet (strict mode)
+    InvalidPadding = 2,   // '=' misplaced or repeated (strict mode)
+    InvalidLength = 3,    // length not a multiple of 4 (strict mode)
+    NonCanonical = 4      // padded quantum with non-zero unused bits (strict mode)
+};
+
+// Base64Kernel selects the decoder implementation. Auto picks the fastest
+// kernel supported by the running CPU; kernels the CPU lacks fall back to Scalar.
+enum class Base64Kernel {
+    Auto = 0,
+    Scalar = 1,
+    SSE41 = 2,
+    AVX2 = 3
+};
+
+struct Base64Result {
+    Base64Status status = Base64Status::Ok;
+    size_t written = 0;      // bytes written to the output
+    size_t error_offset = 0; // input offset of the first invalid byte
+};
+
+// Upper bound of the decoded size, used to pre-size output buffers
+inline size_t Base64DecodedMaxSize(size_t encoded_size) {
+    return encoded_size / 4 * 3 + (encoded_size % 4) * 3 / 4;
+}
+
+// Decode standard-alphabet base64 into out, which must have room for
+// Base64DecodedMaxSize(input.size()) bytes.
+//
+// Lenient mode (strict == false) matches the historical decoder: bytes outside
+// the alphabet are skipped and decoding stops at the first '='.
+// Strict mode requires padded input and stops at the first error.
+Base64Result Base64Decode(std::string_view input, uint8_t* out,
+                          bool strict = false,
+                          Base64Kernel kernel = Base64Kernel::Auto);
+
+// Decode into a vector, resized to the decoded length
+Base64Status Base64Decode(std::string_view input, std::vector<uint8_t>& out, bool strict = false);
+
+// Kernel that Base64Kernel::Auto resolves to on this machine
+Base64Kernel Base64ActiveKernel();
+
+const char* Base64KernelName(Base64Kernel kernel);
+
+} // namespace optimum_p2p
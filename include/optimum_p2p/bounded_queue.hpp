@@ -0,0 +1,136 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+namespace optimum_p2p {
+
+// BoundedQueue is a blocking multi-producer/multi-consumer FIFO with a
+// capacity limit. Push blocks while the queue is full, TryPush fails instead
+// (backpressure) and PushDropOldest evicts from the front. After Close, pushes
+// fail and the Pop variants drain what is left.
+template <typename T>
+class BoundedQueue {
+public:
+    explicit BoundedQueue(size_t capacity)
+        : capacity_(capacity > 0 ? capacity : 1), closed_(false) {}
+    
+    BoundedQueue(const BoundedQueue&) = delete;
+    BoundedQueue& operator=(const BoundedQueue&) = delete;
+    
+    // Block until there is room; item is only moved from on success
+    bool Push(T&& item) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_full_.wait(lock, [this]() { return closed_ || items_.size() < capacity_; });
+        if (closed_) {
+            return false;
+        }
+        items_.push_back(std::move(item));
+        not_empty_.notify_one();
+        return true;
+    }
+    
+    // Returns false without blocking if the queue is full or closed
+    bool TryPush(T&& item) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (closed_ || items_.size() >= capacity_) {
+            return false;
+        }
+        items_.push_back(std::move(item));
+        not_empty_.notify_one();
+        return true;
+    }
+    
+    // Never blocks: when full, the oldest items are evicted to make room and
+    // counted in dropped. Returns false only once closed.
+    bool PushDropOldest(T&& item, size_t& dropped) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        dropped = 0;
+        if (closed_) {
+            return false;
+        }
+        while (items_.size() >= capacity_) {
+            items_.pop_front();
+            dropped++;
+        }
+        items_.push_back(std::move(item));
+        not_empty_.notify_one();
+        return true;
+    }
+    
+    // Block until an item is available; false once closed and drained
+    bool Pop(T& item) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_empty_.wait(lock, [this]() { return closed_ || !items_.empty(); });
+        if (items_.empty()) {
+            return false;
+        }
+        item = std::move(items_.front());
+        items_.pop_front();
+        not_full_.notify_one();
+        return true;
+    }
+    
+    // Like Pop, but gives up after timeout (zero polls without waiting)
+    bool PopFor(T& item, std::chrono::milliseconds timeout) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_empty_.wait_for(lock, timeout, [this]() { return closed_ || !items_.empty(); });
+        if (items_.empty()) {
+            return false;
+        }
+        item = std::move(items_.front());
+        items_.pop_front();
+        not_full_.notify_one();
+        return true;
+    }
+    
+    // Wait up to timeout for the first item, then append up to max items to
+    // out without waiting further. Returns the number of items taken.
+    size_t PopBatch(std::vector<T>& out, size_t max, std::chrono::milliseconds timeout) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_empty_.wait_for(lock, timeout, [this]() { return closed_ || !items_.empty(); });
+        
+        size_t taken = 0;
+        while (taken < max && !items_.empty()) {
+            out.push_back(std::move(items_.front()));
+            items_.pop_front();
+            taken++;
+        }
+        if (taken > 0) {
+            not_full_.notify_all();
+        }
+        return taken;
+    }
+    
+    void Close() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closed_ = true;
+        not_empty_.notify_all();
+        not_full_.notify_all();
+    }
+    
+    void SetCapacity(size_t capacity) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        capacity_ = capacity > 0 ? capacity : 1;
+        not_full_.notify_all();
+    }
+    
+    size_t Size() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return items_.size();
+    }
+
+private:
+    mutable std::mutex mutex_;
+    std::condition_variable not_empty_;
+    std::condition_variable not_full_;
+    std::deque<T> items_;
+    size_t capacity_;
+    bool closed_;
+};
+
+} // namespace optimum_p2p
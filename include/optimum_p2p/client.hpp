@@ -1,6 +1,12 @@
 #pragma once
 
 #include "types.hpp"
+#include "utils.hpp"
+#include "async_engine.hpp"
+#include "bounded_queue.hpp"
+#include "dispatch_pool.hpp"
+#include "gossipsub_trace.hpp"
+#include "mump2p_trace.hpp"
 #include <string>
 #include <vector>
 #include <functional>
@@ -8,6 +14,9 @@
 #include <memory>
 #include <thread>
 #include <atomic>
+#include <future>
+#include <mutex>
+#include <condition_variable>
 
 // Include protobuf and gRPC headers for Phase 1 (will optimize in Phase 2)
 #include "p2p_stream.grpc.pb.h"
@@ -17,34 +26,159 @@ namespace optimum_p2p {
 
 class P2PClient {
 public:
+    // Blocking mode: one dedicated receive thread per stream
     explicit P2PClient(const std::string& address);
+    
+    // Async mode: the stream is driven by the engine's poller threads and
+    // callbacks are invoked from those threads. Callbacks must not block on
+    // this client (Publish/Subscribe/Shutdown) since that would stall the poller.
+    P2PClient(const std::string& address, std::shared_ptr<AsyncEngine> engine);
+    
     ~P2PClient();
     
     // Subscribe to topic
     bool Subscribe(const std::string& topic);
     
-    // Publish message
+    // Publish message and wait for the write to complete. Thread-safe.
     bool Publish(const std::string& topic, const std::vector<uint8_t>& data);
     
-    // Receive messages (blocking)
+    // Pipelined publish: queue the message and return immediately. The future
+    // resolves to the write result. Blocks while the send queue is full.
+    std::future<bool> PublishAsync(const std::string& topic, const std::vector<uint8_t>& data);
+    
+    // Non-blocking variant for backpressure: returns false, without queueing,
+    // if the send queue is full
+    bool TryPublishAsync(const std::string& topic,
+                         const std::vector<uint8_t>& data,
+                         std::future<bool>& result);
+    
+    // Publish many messages to one topic with as few stream flushes as possible:
+    // every write but the last carries a buffer hint so gRPC coalesces them.
+    // Returns one result per payload.
+    std::vector<bool> PublishBatch(const std::string& topic,
+                                   const std::vector<std::vector<uint8_t>>& payloads);
+    
+    // Maximum number of queued, not yet written messages (default 1024)
+    void SetSendQueueDepth(size_t depth);
+    
+    // Messages arriving while no message callback is set are kept in a bounded
+    // receive queue. ReceiveMessage waits up to timeout for one of them (zero
+    // polls); ReceiveBatch appends up to max messages to out and returns how
+    // many it added. Both keep draining the queue after Shutdown.
     bool ReceiveMessage(P2PMessage& message, std::chrono::milliseconds timeout);
+    size_t ReceiveBatch(std::vector<P2PMessage>& out, size_t max, std::chrono::milliseconds timeout);
+    
+    // Receive queue capacity (default 1024) and what to do when it is full
+    // (default Block, DropOldest in async mode). Until the first
+    // ReceiveMessage or ReceiveBatch a full queue always drops its oldest
+    // message, so a client nobody reads from never stalls. In async mode Block
+    // stalls the engine's poller thread, and with it other clients' streams,
+    // until the queue is drained.
+    void SetReceiveQueueDepth(size_t depth);
+    void SetReceiveOverflowPolicy(OverflowPolicy policy);
+    ReceiveQueueStats GetReceiveQueueStats() const;
     
     // Non-blocking message reception via callback
     void SetMessageCallback(std::function<void(const P2PMessage&)> callback);
     
+    // Zero-copy variant: the view borrows from the receive buffer and is only
+    // valid during the call (use P2PMessageView::ToOwned() to keep it)
+    void SetMessageViewCallback(std::function<void(const P2PMessageView&)> callback);
+    
+    // Run message callbacks on the pool's workers so the reading thread only
+    // reads and parses. Messages with the same topic (PerTopic) or source node
+    // (PerSource) are delivered in order. Set before Subscribe; nullptr goes
+    // back to inline callbacks. Shutdown waits for this client's queued
+    // callbacks, so they must not call Shutdown themselves.
+    void SetDispatchPool(std::shared_ptr<DispatchPool> pool, DispatchOrder order = DispatchOrder::PerTopic);
+    
+    // Raw trace events as received (type is MessageTraceGossipSub or
+    // MessageTraceMumP2P). The event bytes are only valid during the call,
+    // which runs on the receiving thread and should not block. Set before
+    // Subscribe.
+    void SetTraceCallback(std::function<void(ResponseType type, std::string_view event)> callback);
+    
+    // Pass only this fraction (0-1, default 1) of trace events to the trace
+    // callback, evenly spaced. Aggregators and trackers still see every event.
+    void SetTraceSampleRate(double rate);
+    
+    // Feed received GossipSub trace events into aggregator; several clients
+    // may share one. Set before Subscribe; nullptr stops feeding.
+    void SetGossipSubAggregator(std::shared_ptr<GossipSubTraceAggregator> aggregator);
+    
+    // Feed received mump2p trace events into tracker; several clients may
+    // share one. Set before Subscribe; nullptr stops feeding.
+    void SetPropagationTracker(std::shared_ptr<PropagationTracker> tracker);
+    
+    // How the Message field of received envelopes is decoded (default Auto)
+    void SetPayloadEncoding(PayloadEncoding encoding);
+    
+    // Received messages dropped because their envelope could not be decoded
+    uint64_t GetDecodeFailures() const;
+    
     // Graceful shutdown
     void Shutdown();
 
 private:
+    class AsyncStream;
+    
+    // A queued write and the promise completed once it has been written
+    struct PendingWrite {
+        proto::Request request;
+        grpc::WriteOptions options;
+        std::promise<bool> done;
+    };
+    
+    bool Connect(const std::string& address);
     void ReceiveLoop(); // Internal receive loop running in separate thread
+    void SendLoop();    // Blocking mode writer, started by the first queued write
+    void HandleResponse(const proto::Response& response);
+    void QueueReceived(P2PMessage message);
+    void DispatchMessage(const P2PMessageView& view);
+    void InvokeCallbacks(const P2PMessage& message);
+    void FinishDispatch();
+    void ForwardTrace(ResponseType type, const std::string& event);
+    bool Write(Command command, const std::string& topic, const uint8_t* data, size_t size);
+    proto::Request* ReusableRequestLocked(); // write_mutex_ held
+    bool Enqueue(PendingWrite& write, bool block); // moves write on success
+    static proto::Request MakePublishRequest(const std::string& topic, const std::vector<uint8_t>& data);
     
     std::unique_ptr<proto::CommandStream::Stub> stub_;
     std::shared_ptr<grpc::Channel> channel_;
     std::unique_ptr<grpc::ClientContext> context_;
     std::unique_ptr<grpc::ClientReaderWriter<proto::Request, proto::Response>> stream_;
     std::thread receive_thread_;
+    std::mutex write_mutex_; // serialises writes on stream_
+    google::protobuf::Arena request_arena_; // guarded by write_mutex_
+    proto::Request* request_;               // on request_arena_, reused by direct writes
+    BoundedQueue<PendingWrite> send_queue_;
+    std::thread send_thread_;
+    std::mutex send_thread_mutex_; // starting send_thread_ vs Shutdown closing send_queue_
+    std::atomic<bool> send_thread_started_;
     std::atomic<bool> running_;
+    std::atomic<PayloadEncoding> payload_encoding_;
+    BoundedQueue<P2PMessage> receive_queue_;
+    std::atomic<OverflowPolicy> receive_policy_;
+    std::atomic<uint64_t> received_queued_;
+    std::atomic<uint64_t> received_dropped_oldest_;
+    std::atomic<uint64_t> received_dropped_newest_;
+    std::atomic<bool> receive_consumer_; // set by the first ReceiveMessage/ReceiveBatch
+    std::atomic<uint64_t> decode_failures_;
     std::function<void(const P2PMessage&)> message_callback_;
+    std::function<void(const P2PMessageView&)> message_view_callback_;
+    MessageDecoder decoder_; // used by the receiving thread only
+    std::shared_ptr<AsyncEngine> engine_;
+    std::unique_ptr<AsyncStream> async_stream_;
+    std::shared_ptr<DispatchPool> dispatch_pool_;
+    DispatchOrder dispatch_order_;
+    std::atomic<size_t> dispatch_pending_; // callbacks queued on dispatch_pool_
+    std::mutex dispatch_mutex_;
+    std::condition_variable dispatch_idle_;
+    std::shared_ptr<GossipSubTraceAggregator> gossipsub_aggregator_;
+    std::shared_ptr<PropagationTracker> propagation_tracker_;
+    std::function<void(ResponseType, std::string_view)> trace_callback_;
+    std::atomic<double> trace_sample_rate_;
+    double trace_sample_credit_; // used by the receiving thread only
 };
 
 } // namespace optimum_p2p
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "bounded_queue.hpp"
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <atomic>
+
+namespace optimum_p2p {
+
+// DispatchPool runs message callbacks on worker threads so a stream's reader
+// only reads and parses. Jobs are sharded by key: all jobs with the same key
+// run on the same worker, in submission order, so ordering per key (topic or
+// source node) is preserved while different keys run in parallel.
+//
+// Like AsyncEngine, one pool can be shared by many clients and must outlive
+// every client using it (clients hold a shared_ptr).
+class DispatchPool {
+public:
+    // num_threads == 0 uses std::thread::hardware_concurrency(). Each worker
+    // queues up to queue_depth jobs; Submit blocks beyond that, which pushes
+    // back on the stream reader instead of buffering without bound.
+    explicit DispatchPool(size_t num_threads = 0, size_t queue_depth = 1024);
+    ~DispatchPool();
+    
+    DispatchPool(const DispatchPool&) = delete;
+    DispatchPool& operator=(const DispatchPool&) = delete;
+    
+    // Queue job on the worker owning key. False once the pool is shut down.
+    bool Submit(size_t key, std::function<void()> job);
+    
+    size_t NumThreads() const { return workers_.size(); }
+    
+    // Run the jobs already queued, then join the workers
+    void Shutdown();
+
+private:
+    struct Worker {
+        explicit Worker(size_t depth) : queue(depth) {}
+        BoundedQueue<std::function<void()>> queue;
+        std::thread thread;
+    };
+    
+    static void WorkerLoop(Worker& worker);
+    
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::atomic<bool> running_;
+};
+
+} // namespace optimum_p2p
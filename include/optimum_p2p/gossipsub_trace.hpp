@@ -0,0 +1,101 @@
+#pragma once
+
+#include "histogram.hpp"
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace optimum_p2p {
+
+// Per-topic view of the GossipSub trace events seen by a GossipSubTraceAggregator
+struct GossipSubTopicStats {
+    uint64_t published = 0;
+    uint64_t delivered = 0;
+    uint64_t duplicates = 0;
+    uint64_t rejected = 0;
+    uint64_t forwarded = 0;  // message copies sent to peers (SEND_RPC)
+    size_t mesh_nodes = 0;   // traced nodes currently holding mesh peers in the topic
+    size_t mesh_peers = 0;   // mesh links over all those nodes (GRAFT minus PRUNE)
+    
+    // Nanoseconds from the message's publish event (or, if that was not
+    // traced, its earliest sighting) to each DELIVER_MESSAGE
+    HistogramSnapshot delivery_latency;
+};
+
+// Totals over all topics
+struct GossipSubTraceTotals {
+    uint64_t events = 0;
+    uint64_t decode_errors = 0;
+    std::map<std::string, uint64_t> events_by_type; // keyed by TraceEvent type name
+};
+
+// GossipSubTraceAggregator folds serialized go-libp2p-pubsub TraceEvents
+// (MessageTraceGossipSub responses) from any number of clients into per-topic
+// counters and latency histograms that can be queried while traces arrive.
+// Thread-safe: events are decoded outside the lock into a per-thread message,
+// so only the counter updates are serialized.
+class GossipSubTraceAggregator {
+public:
+    // max_tracked_messages bounds the table of first sightings used for
+    // delivery latency; the oldest message is forgotten first
+    explicit GossipSubTraceAggregator(size_t max_tracked_messages = 65536);
+    ~GossipSubTraceAggregator();
+    
+    // Returns false if data is not a TraceEvent
+    bool Add(std::string_view data);
+    bool Add(const uint8_t* data, size_t size);
+    
+    std::map<std::string, GossipSubTopicStats> GetTopicStats() const;
+    
+    // Returns false if no event for topic has been seen
+    bool GetTopicStats(const std::string& topic, GossipSubTopicStats& stats) const;
+    
+    GossipSubTraceTotals GetTotals() const;
+    
+    void Reset();
+
+private:
+    static constexpr size_t kNumEventTypes = 13;
+    
+    struct TopicState {
+        uint64_t published = 0;
+        uint64_t delivered = 0;
+        uint64_t duplicates = 0;
+        uint64_t rejected = 0;
+        uint64_t forwarded = 0;
+        LatencyHistogram delivery_latency;
+        // node -> its mesh peers, both as hashed peer IDs
+        std::unordered_map<uint64_t, std::unordered_set<uint64_t>> mesh;
+    };
+    
+    struct MessageInfo {
+        int64_t first_seen;
+        bool published;
+    };
+    
+    TopicState& TopicLocked(const std::string& topic);
+    
+    // Record a sighting and return the message's reference timestamp
+    int64_t FirstSeenLocked(const std::string& message_id, int64_t timestamp, bool publish);
+    
+    static void FillStats(const TopicState& state, GossipSubTopicStats& stats);
+    
+    mutable std::mutex mutex_;
+    size_t max_tracked_messages_;
+    std::map<std::string, std::unique_ptr<TopicState>, std::less<>> topics_;
+    std::unordered_map<uint64_t, MessageInfo> messages_; // keyed by hashed message ID
+    std::deque<uint64_t> message_order_;                 // insertion order, for eviction
+    uint64_t events_;
+    uint64_t decode_errors_;
+    std::array<uint64_t, kNumEventTypes> events_by_type_;
+};
+
+} // namespace optimum_p2p
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace optimum_p2p {
+
+// HistogramSnapshot is a point-in-time copy of a LatencyHistogram.
+//
+// Buckets are log-linear (HDR style): values below 2^kSubBucketBits are
+// counted exactly, and every power of two above that is split into
+// 2^kSubBucketBits equal buckets, so any recorded value is reported within
+// about 3% over the whole uint64_t range. Units are up to the caller.
+class HistogramSnapshot {
+public:
+    static constexpr int kSubBucketBits = 5;
+    static constexpr size_t kSubBuckets = size_t(1) << kSubBucketBits;
+    static constexpr size_t kNumBuckets = (64 - kSubBucketBits + 1) * kSubBuckets;
+    
+    static size_t BucketIndex(uint64_t value);
+    static uint64_t BucketLow(size_t index);
+    static uint64_t BucketHigh(size_t index);
+    
+    uint64_t Count() const { return count_; }
+    uint64_t Min() const { return count_ ? min_ : 0; }
+    uint64_t Max() const { return max_; }
+    double Mean() const;
+    
+    // Value at or below which percentile (0-100) of the recorded values fall,
+    // rounded up to its bucket and clamped to [Min, Max]
+    uint64_t Percentile(double percentile) const;
+    
+    // Add another snapshot's values, e.g. to combine per-pair histograms
+    void Merge(const HistogramSnapshot& other);
+    
+    uint64_t BucketCount(size_t index) const { return counts_[index]; }
+
+private:
+    friend class LatencyHistogram;
+    
+    std::array<uint64_t, kNumBuckets> counts_{};
+    uint64_t count_ = 0;
+    uint64_t sum_ = 0;
+    uint64_t min_ = UINT64_MAX;
+    uint64_t max_ = 0;
+};
+
+// LatencyHistogram records values from any number of threads without locks
+// (one relaxed atomic increment per value) and can be read while recording.
+class LatencyHistogram {
+public:
+    LatencyHistogram();
+    
+    LatencyHistogram(const LatencyHistogram&) = delete;
+    LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+    
+    void Record(uint64_t value);
+    
+    // Values recorded concurrently may or may not be included
+    HistogramSnapshot Snapshot() const;
+    
+    void Reset();
+
+private:
+    std::array<std::atomic<uint64_t>, HistogramSnapshot::kNumBuckets> counts_;
+    std::atomic<uint64_t> sum_;
+    std::atomic<uint64_t> min_;
+    std::atomic<uint64_t> max_;
+};
+
+} // namespace optimum_p2p
@@ -0,0 +1,107 @@
+#pragma once
+
+#include "histogram.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace optimum_p2p {
+
+// Parse the "[<unix-nanos> <size>] " prefix MultiPublishClient puts in front
+// of published payloads. Reads in place; returns false if there is no prefix.
+bool ParsePublishPrefix(std::string_view payload, int64_t& publish_nanos, size_t& size);
+
+// Latency histogram of one (source node, receiving node) pair
+struct LatencyPairStats {
+    std::string source;   // SourceNodeID of the message envelope
+    std::string receiver; // address of the node the message was received from
+    HistogramSnapshot latency; // nanoseconds
+};
+
+// LatencyTracker records publish-to-receive latency of timestamped messages
+// per (source, receiver) pair. Recording takes a shared lock to find the pair
+// and then updates its histogram without locking, so receiving threads of
+// many nodes can record concurrently. Latency relies on the publisher's and
+// subscriber's clocks agreeing; negative latencies are recorded as 0 and
+// counted as clock skew.
+//
+// Each pair costs one LatencyHistogram, about 15 KB, so N sources seen through
+// M nodes take N * M * 15 KB. Once max_pairs pairs exist, a new pair is
+// recorded in its receiver's ("*", receiver) pair instead, one per receiver
+// on top of max_pairs. A max_pairs of 0 tracks only those per-receiver pairs.
+class LatencyTracker {
+public:
+    // The default 1024 pairs hold about 15 MB of histograms
+    explicit LatencyTracker(size_t max_pairs = 1024);
+    ~LatencyTracker();
+    
+    LatencyTracker(const LatencyTracker&) = delete;
+    LatencyTracker& operator=(const LatencyTracker&) = delete;
+    
+    // Record the latency of a received payload; returns false (and counts it)
+    // if the payload has no timestamp prefix
+    bool Record(std::string_view source, std::string_view receiver,
+                std::string_view payload, int64_t receive_nanos);
+    void RecordLatency(std::string_view source, std::string_view receiver, int64_t latency_nanos);
+    
+    std::vector<LatencyPairStats> GetSnapshot() const;
+    
+    // Returns false if nothing was recorded for the pair, e.g. because it was
+    // merged into its receiver's ("*", receiver) pair
+    bool GetPairSnapshot(std::string_view source, std::string_view receiver, HistogramSnapshot& snapshot) const;
+    
+    // All pairs merged
+    HistogramSnapshot GetTotal() const;
+    
+    uint64_t MissingPrefix() const { return missing_prefix_.load(std::memory_order_relaxed); }
+    uint64_t ClockSkew() const { return clock_skew_.load(std::memory_order_relaxed); }
+    
+    // Latencies recorded in a ("*", receiver) pair because of max_pairs
+    uint64_t MergedRecords() const { return merged_records_.load(std::memory_order_relaxed); }
+    
+    // Tab-separated summary, one line per pair plus a total, latencies in
+    // microseconds: source receiver count p50 p90 p99 max
+    std::string Summary() const;
+    
+    // Pass Summary() to sink every interval from a background thread until
+    // StopPeriodicSummary or destruction. Replaces a running dump.
+    void StartPeriodicSummary(std::chrono::milliseconds interval,
+                              std::function<void(const std::string&)> sink);
+    void StopPeriodicSummary();
+    
+    // Clear all histograms and counters; known pairs stay listed
+    void Reset();
+
+private:
+    struct Pair {
+        std::string source;
+        std::string receiver;
+        LatencyHistogram latency;
+    };
+    
+    LatencyHistogram& PairHistogram(std::string_view source, std::string_view receiver);
+    
+    size_t max_pairs_;
+    mutable std::shared_mutex pairs_mutex_;
+    std::unordered_map<std::string, std::unique_ptr<Pair>> pairs_; // keyed by source '\t' receiver
+    std::atomic<uint64_t> missing_prefix_;
+    std::atomic<uint64_t> clock_skew_;
+    std::atomic<uint64_t> merged_records_;
+    
+    std::mutex summary_mutex_;
+    std::condition_variable summary_cv_;
+    bool summary_stop_;
+    std::thread summary_thread_;
+};
+
+} // namespace optimum_p2p
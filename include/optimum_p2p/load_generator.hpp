@@ -0,0 +1,143 @@
+#pragma once
+
+#include "histogram.hpp"
+#include "log_writer.hpp"
+#include "payload_generator.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace optimum_p2p {
+
+// ArrivalProcess spaces the messages of a load run
+enum class ArrivalProcess : int32_t {
+    Constant = 0, // evenly spaced at the target rate
+    Poisson = 1   // exponential gaps averaging the target rate
+};
+
+// LoadProfile describes an open-loop load run, per node
+struct LoadProfile {
+    double rate = 100;                       // target messages per second
+    double start_rate = 0;                   // rate at the start of the ramp
+    std::chrono::milliseconds ramp{0};       // linear ramp from start_rate to rate
+    std::chrono::milliseconds duration{0};   // 0 runs until Stop
+    ArrivalProcess arrivals = ArrivalProcess::Constant;
+    size_t payload_size = 256;               // bytes after the timestamp prefix
+    uint32_t seed = 1;                       // Poisson gaps; node i uses seed + i
+};
+
+// LoadSchedule yields the send times of a profile as offsets from the start
+// of the run. Times come from the integrated rate, so they do not drift and a
+// ramp sends exactly the messages its average rate implies.
+class LoadSchedule {
+public:
+    LoadSchedule(const LoadProfile& profile, uint32_t seed);
+    
+    // Offset of the next message; nanoseconds::max() once the rate is 0 for good
+    std::chrono::nanoseconds Next();
+    
+    // Messages the profile calls for in the first seconds of the run
+    // (the expected number for Poisson arrivals)
+    double MessagesBy(double seconds) const;
+
+private:
+    // Inverse of MessagesBy
+    double TimeOf(double messages) const;
+    
+    double rate_;
+    double start_rate_;
+    double ramp_;          // seconds
+    double ramp_messages_; // MessagesBy(ramp_)
+    bool poisson_;
+    double position_;      // MessagesBy of the next send
+    std::mt19937_64 rng_;
+    std::exponential_distribution<double> gap_;
+};
+
+// Send statistics of one node, or all nodes merged (address "*")
+struct LoadNodeStats {
+    std::string address;
+    uint64_t sent = 0;
+    uint64_t failed = 0;             // publishes that failed even after reconnecting
+    double target_rate = 0;          // messages per second the schedule asked for so far
+    double achieved_rate = 0;        // messages per second actually sent
+    HistogramSnapshot send_latency;  // scheduled time to Publish returning, nanoseconds
+    HistogramSnapshot publish_time;  // Publish call alone, nanoseconds
+};
+
+// LoadGenerator publishes to every node on its own thread and connection
+// following a LoadProfile. It is open loop: messages are due at their
+// scheduled time whether or not earlier publishes have finished, and a node
+// that falls behind sends its overdue messages back to back. send_latency is
+// measured from the scheduled time, so it includes that backlog instead of
+// hiding it. Default payloads carry MultiPublishClient's
+// "[<unix-nanos> <size>] " prefix so subscribers can measure end-to-end
+// latency.
+class LoadGenerator {
+public:
+    explicit LoadGenerator(const std::vector<std::string>& addresses);
+    ~LoadGenerator();
+    
+    LoadGenerator(const LoadGenerator&) = delete;
+    LoadGenerator& operator=(const LoadGenerator&) = delete;
+    
+    // Log published messages like MultiPublishClient (before Start)
+    void SetOutputFile(const std::string& filename);
+    
+    // Replace how messages are built (before Start). Generate is called with
+    // payload_size filler bytes as data, the node's message number as index
+    // and a count of 1; the default, DefaultPayloadGenerator, sends the
+    // timestamp prefix followed by the filler.
+    void SetPayloadGenerator(std::shared_ptr<PayloadGenerator> generator);
+    
+    // Start publishing on topic; returns false if a run is in progress or the
+    // profile has no positive rate
+    bool Start(const std::string& topic, const LoadProfile& profile);
+    
+    // Block until the profile's duration has elapsed (or Stop was called)
+    void Wait();
+    
+    // End the run early; pending messages are not sent
+    void Stop();
+    
+    bool Running() const;
+    
+    // Live while running, final afterwards
+    std::vector<LoadNodeStats> GetStats() const;
+    LoadNodeStats GetTotal() const;
+    
+    // Tab-separated summary, one line per node plus a total, latencies in
+    // microseconds: address sent failed target_rate achieved_rate
+    // send_p50_us send_p99_us send_max_us publish_p50_us publish_p99_us
+    std::string Summary() const;
+
+private:
+    struct Node;
+    
+    void NodeLoop(Node& node, const std::string& topic, uint32_t seed);
+    void Join();
+    double Elapsed() const; // seconds of the current or last run, mutex_ held
+    
+    std::vector<std::string> addresses_;
+    std::vector<std::unique_ptr<Node>> nodes_;
+    LoadProfile profile_;
+    std::unique_ptr<AsyncLogWriter> output_writer_;
+    std::shared_ptr<PayloadGenerator> payload_generator_;
+    
+    mutable std::mutex mutex_;
+    std::condition_variable stop_cv_;
+    std::atomic<bool> stop_;
+    std::atomic<size_t> active_; // nodes still publishing
+    std::mutex join_mutex_;
+    std::chrono::steady_clock::time_point started_;
+    std::chrono::steady_clock::time_point finished_; // set when the last node is done
+};
+
+} // namespace optimum_p2p
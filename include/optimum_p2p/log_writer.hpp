@@ -0,0 +1,87 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <fstream>
+#include <future>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace optimum_p2p {
+
+// AsyncLogWriter appends text to a file from a background thread.
+//
+// Producers hand complete lines (or chunks of lines) to Write, which only
+// pushes onto a lock-free multi-producer queue; the writer thread keeps the
+// file open, batches chunks and writes them out once flush_bytes have
+// accumulated or flush_interval has passed. Write never blocks on I/O.
+class AsyncLogWriter {
+public:
+    struct Options {
+        size_t flush_bytes = 64 * 1024;
+        std::chrono::milliseconds flush_interval = std::chrono::milliseconds(100);
+        bool append = true; // false truncates the file on open
+    };
+    
+    explicit AsyncLogWriter(const std::string& filename);
+    AsyncLogWriter(const std::string& filename, const Options& options);
+    
+    // Writes everything still queued and closes the file
+    ~AsyncLogWriter();
+    
+    AsyncLogWriter(const AsyncLogWriter&) = delete;
+    AsyncLogWriter& operator=(const AsyncLogWriter&) = delete;
+    
+    bool IsOpen() const { return open_; }
+    
+    // Queue data for writing. Safe to call from any number of threads.
+    void Write(std::string data);
+    
+    // Block until everything queued before this call has been written to the file
+    void Flush();
+    
+    // Flush and stop the writer thread; later writes are dropped
+    void Close();
+
+private:
+    struct Node {
+        std::atomic<Node*> next{nullptr};
+        std::string data;
+        std::promise<void>* flushed = nullptr; // set for Flush markers
+    };
+    
+    // Vyukov intrusive MPSC queue: Push from any thread, Pop from the writer only
+    void Push(Node* node);
+    Node* Pop();
+    
+    // Bracket a Push so Close's final drain cannot miss it; BeginProduce
+    // returns false once closed
+    bool BeginProduce();
+    void EndProduce();
+    
+    void Wake();
+    void Run();
+    void WriteBatch();
+    
+    Options options_;
+    std::ofstream file_;
+    bool open_;
+    
+    std::atomic<Node*> head_;
+    Node* tail_;
+    Node stub_;
+    
+    std::string batch_; // writer thread only
+    std::atomic<size_t> pending_bytes_;
+    std::atomic<bool> closed_;
+    std::atomic<size_t> producers_; // Write/Flush calls between the closed_ check and their push
+    std::mutex wake_mutex_;
+    std::condition_variable wake_;
+    bool wake_pending_; // guarded by wake_mutex_
+    std::thread thread_;
+};
+
+} // namespace optimum_p2p
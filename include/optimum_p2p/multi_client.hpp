@@ -1,6 +1,10 @@
 #pragma once
 
 #include "client.hpp"
+#include "latency_tracker.hpp"
+#include "log_writer.hpp"
+#include "node_publisher.hpp"
+#include "payload_generator.hpp"
 #include <string>
 #include <vector>
 #include <functional>
@@ -15,53 +19,107 @@ public:
     explicit MultiPublishClient(const std::vector<std::string>& addresses);
     ~MultiPublishClient();
     
-    // Publish to all nodes concurrently
+    // Publish to all nodes concurrently. Each node has a persistent connection
+    // and worker thread, created on the first call and reused afterwards;
+    // a connection that fails to publish is re-established once per message.
     void PublishAll(const std::string& topic, 
                    const std::vector<uint8_t>& data,
                    int count = 1,
                    std::chrono::milliseconds delay = std::chrono::milliseconds(0));
     
-    // Set output file for logging
+    // Set output file for logging. Publisher threads buffer their lines and
+    // hand them to a background writer, so logging does not slow publishing.
     void SetOutputFile(const std::string& filename);
     
+    // Maximum time a logged line waits before reaching the file (default 100ms)
+    void SetFlushInterval(std::chrono::milliseconds interval);
+    
+    // Block until every line logged by completed publishes is written
+    void Flush();
+    
+    // Replace how payloads are built from PublishAll's data (default:
+    // DefaultPayloadGenerator). Set before PublishAll.
+    void SetPayloadGenerator(std::shared_ptr<PayloadGenerator> generator);
+
 private:
-    void PublishToNode(const std::string& address,
+    struct Worker;
+    
+    void StartWorkers();
+    void WorkerLoop(Worker& worker);
+    void PublishToNode(Worker& worker,
                       const std::string& topic,
                       const std::vector<uint8_t>& data,
                       int count,
                       std::chrono::milliseconds delay);
     
     std::vector<std::string> addresses_;
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::mutex publish_mutex_; // one PublishAll round at a time
     std::string output_file_;
-    std::mutex output_mutex_;
+    std::chrono::milliseconds flush_interval_;
+    std::unique_ptr<AsyncLogWriter> output_writer_;
+    std::shared_ptr<PayloadGenerator> payload_generator_;
 };
 
 class MultiSubscribeClient {
 public:
-    explicit MultiSubscribeClient(const std::vector<std::string>& addresses);
+    // With an engine, all node streams share its poller threads instead of
+    // running one receive thread per node
+    explicit MultiSubscribeClient(const std::vector<std::string>& addresses,
+                                  std::shared_ptr<AsyncEngine> engine = nullptr);
     ~MultiSubscribeClient();
     
     // Subscribe to all nodes concurrently
     void SubscribeAll(const std::string& topic);
     
-    // Set callbacks for data and trace output
+    // Set callbacks for data and trace output (before SubscribeAll). Trace
+    // lines use the trace file format (see HandleGossipSubTrace) and are
+    // delivered on the nodes' receiving threads, so the callback should not
+    // block.
     void SetDataCallback(std::function<void(const std::string&, const P2PMessage&)> callback);
     void SetTraceCallback(std::function<void(const std::string&)> callback);
     
-    // Set output files
+    // Fraction of each node's trace events passed to the trace sinks (default 1)
+    void SetTraceSampleRate(double rate);
+    
+    // Set output files (before SubscribeAll). Lines are appended by a
+    // background writer, see AsyncLogWriter.
     void SetDataOutputFile(const std::string& filename);
     void SetTraceOutputFile(const std::string& filename);
     
+    // Aggregate GossipSub traces from every node into one aggregator (before SubscribeAll)
+    void SetGossipSubAggregator(std::shared_ptr<GossipSubTraceAggregator> aggregator);
+    
+    // Track mump2p propagation across all nodes (before SubscribeAll). If the
+    // tracker has no expected node count, it is set to the number of nodes
+    // subscribed.
+    void SetPropagationTracker(std::shared_ptr<PropagationTracker> tracker);
+    
+    // Record publish-to-receive latency of messages carrying MultiPublishClient's
+    // "[<unix-nanos> <size>] " prefix, per (source node, receiving address)
+    // pair (before SubscribeAll)
+    void SetLatencyTracker(std::shared_ptr<LatencyTracker> tracker);
+    
+    // Block until all data and trace lines received so far are written
+    void Flush();
+
 private:
-    void HandleMessage(const std::string& address, const P2PMessage& msg);
+    void HandleMessage(const std::string& address, const P2PMessageView& msg);
+    void HandleTrace(ResponseType type, std::string_view event);
     
     std::vector<std::unique_ptr<P2PClient>> clients_;
     std::vector<std::string> addresses_;
+    std::shared_ptr<AsyncEngine> engine_;
     std::function<void(const std::string&, const P2PMessage&)> data_callback_;
     std::function<void(const std::string&)> trace_callback_;
     std::string data_output_file_;
     std::string trace_output_file_;
-    std::mutex file_mutex_;
+    std::unique_ptr<AsyncLogWriter> data_writer_;
+    std::unique_ptr<AsyncLogWriter> trace_writer_;
+    double trace_sample_rate_;
+    std::shared_ptr<GossipSubTraceAggregator> gossipsub_aggregator_;
+    std::shared_ptr<PropagationTracker> propagation_tracker_;
+    std::shared_ptr<LatencyTracker> latency_tracker_;
 };
 
 } // namespace optimum_p2p
@@ -0,0 +1,102 @@
+#pragma once
+
+#include "histogram.hpp"
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace optimum_p2p {
+
+// MumP2PTraceEvent is the part of a mump2p trace event needed to follow a
+// message through the network. Views borrow from the decoded buffer.
+struct MumP2PTraceEvent {
+    static constexpr int32_t kPublishMessage = 0;
+    
+    int32_t type = -1;
+    int64_t timestamp = 0; // unix nanoseconds
+    std::string_view peer_id;
+    std::string_view message_id; // empty for events not about a message
+};
+
+// Decode a serialized mump2p TraceEvent without allocating. mump2p traces use
+// the go-libp2p-pubsub TraceEvent layout (type = 1, peerID = 2, timestamp = 3,
+// message ID = field 1 of the publish/reject/duplicate/deliver bodies 4-7),
+// so the decoder reads that layout from the wire and skips fields it does not
+// know, which keeps it working across mump2p-specific event types.
+// Returns false on malformed input or a missing type.
+bool DecodeMumP2PTrace(std::string_view data, MumP2PTraceEvent& event);
+
+// Per-node first sightings of one message
+struct MessageTimeline {
+    int64_t origin = 0;          // publish timestamp, or earliest sighting if not traced
+    bool published = false;      // origin comes from a publish event
+    bool complete = false;       // seen by every expected node
+    std::vector<std::pair<std::string, int64_t>> first_seen; // base58 peer ID, timestamp; by time
+};
+
+struct PropagationStats {
+    size_t expected_nodes = 0;
+    size_t tracked_messages = 0;       // currently held in the store
+    uint64_t complete_messages = 0;    // reached every expected node
+    uint64_t evicted_incomplete = 0;   // dropped from the store before completing
+    HistogramSnapshot time_to_all_nodes; // ns from origin to the last node, per complete message
+    HistogramSnapshot time_to_node;      // ns from origin to each node, for complete messages
+};
+
+// PropagationTracker indexes mump2p trace events from a fleet of nodes by
+// message ID and records when each node first saw each message. Once every
+// expected node has seen a message its propagation times go into the
+// histograms, so percentiles are available while the fleet runs. At most
+// max_messages messages, complete or not, are held with their timelines; the
+// oldest is evicted first. Thread-safe.
+class PropagationTracker {
+public:
+    // expected_nodes of 0 is filled in by MultiSubscribeClient::SubscribeAll
+    explicit PropagationTracker(size_t expected_nodes = 0, size_t max_messages = 65536);
+    ~PropagationTracker();
+    
+    void SetExpectedNodes(size_t expected_nodes);
+    size_t ExpectedNodes() const;
+    
+    // Returns false if data is not a trace event
+    bool Add(std::string_view data);
+    void Record(const MumP2PTraceEvent& event);
+    
+    // Returns false if the message is not (or no longer) in the store
+    bool GetTimeline(std::string_view message_id, MessageTimeline& timeline) const;
+    
+    PropagationStats GetStats() const;
+    
+    void Reset();
+
+private:
+    struct Entry {
+        int64_t origin;
+        bool published;
+        bool complete;
+        std::vector<std::pair<uint32_t, int64_t>> first_seen; // node index, timestamp
+    };
+    
+    uint32_t NodeIndexLocked(std::string_view peer_id);
+    void CompleteLocked(Entry& entry);
+    
+    mutable std::mutex mutex_;
+    size_t expected_nodes_;
+    size_t max_messages_;
+    std::unordered_map<std::string, Entry> messages_;
+    std::deque<const std::string*> message_order_; // keys of messages_, oldest first
+    std::unordered_map<std::string, uint32_t> node_index_;
+    std::vector<std::string> nodes_; // peer IDs by node index
+    uint64_t complete_messages_;
+    uint64_t evicted_incomplete_;
+    LatencyHistogram time_to_all_nodes_;
+    LatencyHistogram time_to_node_;
+};
+
+} // namespace optimum_p2p
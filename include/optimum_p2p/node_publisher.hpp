@@ -0,0 +1,58 @@
+#pragma once
+
+#include "client.hpp"
+#include "log_writer.hpp"
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace optimum_p2p {
+
+// NodePublisher publishes to one node from a single thread, as the per-node
+// threads of MultiPublishClient and LoadGenerator do. A publish that fails
+// reconnects and is retried once. Logged messages become
+// "<address>\t<size>\t<sha256>" lines, buffered locally and handed to the
+// log writer in chunks. Not thread-safe.
+class NodePublisher {
+public:
+    explicit NodePublisher(const std::string& address);
+    
+    // Hands over buffered lines and closes the connection
+    ~NodePublisher();
+    
+    NodePublisher(const NodePublisher&) = delete;
+    NodePublisher& operator=(const NodePublisher&) = delete;
+    
+    const std::string& Address() const { return address_; }
+    
+    // Open the connection now instead of on the first Publish
+    void Connect();
+    
+    // Publish, reconnecting and retrying once if the stream is gone
+    bool Publish(const std::string& topic, const std::vector<uint8_t>& message);
+    
+    // Log lines go to writer (nullptr stops logging) and wait at most
+    // handoff_interval in the local buffer. The writer must outlive its use.
+    void SetLogWriter(AsyncLogWriter* writer, std::chrono::milliseconds handoff_interval);
+    
+    // Log a published message
+    void Log(const std::vector<uint8_t>& message);
+    
+    // Hand buffered lines to the log writer
+    void FlushLog();
+    
+    // FlushLog and close the connection; Publish reconnects
+    void Shutdown();
+
+private:
+    std::string address_;
+    std::unique_ptr<P2PClient> client_;
+    AsyncLogWriter* log_writer_;
+    std::chrono::milliseconds handoff_interval_;
+    std::string log_buffer_;
+    std::chrono::steady_clock::time_point last_handoff_;
+};
+
+} // namespace optimum_p2p
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace optimum_p2p {
+
+// FastRandom is xoshiro256** seeded through splitmix64: a few instructions per
+// 64-bit value and no system calls. Not for cryptographic use.
+class FastRandom {
+public:
+    explicit FastRandom(uint64_t seed);
+    
+    uint64_t Next() {
+        const uint64_t result = Rotl(state_[1] * 5, 7) * 9;
+        const uint64_t t = state_[1] << 17;
+        state_[2] ^= state_[0];
+        state_[3] ^= state_[1];
+        state_[1] ^= state_[2];
+        state_[0] ^= state_[3];
+        state_[2] ^= t;
+        state_[3] = Rotl(state_[3], 45);
+        return result;
+    }
+    
+    // Fill size bytes at out
+    void Fill(uint8_t* out, size_t size);
+    
+    // Generator of the calling thread, seeded once from std::random_device
+    static FastRandom& ThreadLocal();
+    
+    static uint64_t SplitMix64(uint64_t& state);
+
+private:
+    static uint64_t Rotl(uint64_t x, int k) {
+        return (x << k) | (x >> (64 - k));
+    }
+    
+    uint64_t state_[4];
+};
+
+// Longest prefix FormatPublishPrefix writes
+constexpr size_t kMaxPublishPrefixSize = 44;
+
+// Write MultiPublishClient's "[<unix-nanos> <size>] " prefix to out (at least
+// kMaxPublishPrefixSize bytes) and return its length
+size_t FormatPublishPrefix(int64_t publish_nanos, size_t size, char* out);
+
+// PayloadGenerator builds the payloads MultiPublishClient publishes. Generate
+// is called concurrently from the publishing threads of all nodes, and out is
+// the thread's buffer from the previous call, so implementations can reuse its
+// capacity instead of allocating.
+class PayloadGenerator {
+public:
+    virtual ~PayloadGenerator() = default;
+    
+    // Payload of message index (0-based) of count, for the data given to PublishAll
+    virtual void Generate(const std::vector<uint8_t>& data, int index, int count,
+                          std::vector<uint8_t>& out) = 0;
+};
+
+// The Go client's format: a single message is the timestamp prefix followed
+// by data; with count > 1 every message is
+//   "[<unix-nanos> 8] <index + 1> - <8 random hex digits> XXX"
+class DefaultPayloadGenerator : public PayloadGenerator {
+public:
+    void Generate(const std::vector<uint8_t>& data, int index, int count,
+                  std::vector<uint8_t>& out) override;
+};
+
+// Timestamp prefix followed by size random bytes, for load tests where
+// payloads should not compress or deduplicate
+class RandomPayloadGenerator : public PayloadGenerator {
+public:
+    explicit RandomPayloadGenerator(size_t size);
+    
+    void Generate(const std::vector<uint8_t>& data, int index, int count,
+                  std::vector<uint8_t>& out) override;
+
+private:
+    size_t size_;
+};
+
+} // namespace optimum_p2p
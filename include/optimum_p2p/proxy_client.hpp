@@ -1,8 +1,11 @@
 #pragma once
 
 #include "types.hpp"
+#include <functional>
+#include <future>
 #include <string>
 #include <memory>
+#include <mutex>
 
 // Include protobuf and gRPC headers for Phase 1 (will optimize in Phase 2)
 #include "proxy_stream.grpc.pb.h"
@@ -12,6 +15,9 @@ namespace optimum_p2p {
 
 class ProxyClient {
 public:
+    // REST calls may be made from several threads at once; each takes a pooled
+    // handle that reuses its connection to rest_url instead of connecting per
+    // request
     ProxyClient(const std::string& rest_url, const std::string& grpc_address);
     ~ProxyClient();
     
@@ -25,6 +31,28 @@ public:
                 const std::string& topic,
                 const std::string& message);
     
+    // Publish via REST API without waiting for the response. Requests are run
+    // by one background thread through curl's multi interface: over https they
+    // share one HTTP/2 connection when the proxy negotiates it, otherwise each
+    // request in flight uses its own kept-alive connection. Blocks while
+    // SetMaxInFlight requests are already outstanding.
+    std::future<bool> PublishAsync(const std::string& client_id,
+                                   const std::string& topic,
+                                   const std::string& message);
+    
+    // As above, calling done with the result on the background thread; done
+    // must not block
+    void PublishAsync(const std::string& client_id,
+                      const std::string& topic,
+                      const std::string& message,
+                      std::function<void(bool)> done);
+    
+    // Maximum async publishes outstanding at once (default 64)
+    void SetMaxInFlight(size_t max_in_flight);
+    
+    // Block until every async publish issued so far has completed
+    void WaitAsync();
+    
     // Connect gRPC stream
     bool ConnectStream(const std::string& client_id);
     
@@ -41,9 +69,20 @@ private:
     std::shared_ptr<grpc::Channel> channel_;
     std::unique_ptr<grpc::ClientContext> context_;
     std::unique_ptr<grpc::ClientReaderWriter<proto::ProxyMessage, proto::ProxyMessage>> stream_;
+    google::protobuf::Arena arena_;
+    proto::ProxyMessage* receive_message_; // on arena_, reused by ReceiveMessage
     
     // REST API helpers
+    struct RestPool; // reusable CURL handles, each keeping its connection
+    struct AsyncRest; // curl multi loop behind PublishAsync
+    std::unique_ptr<RestPool> rest_;
+    std::unique_ptr<AsyncRest> async_; // created by the first PublishAsync
+    std::mutex async_mutex_;           // guards async_ creation
+    size_t max_in_flight_;
     bool PostJSON(const std::string& endpoint, const std::string& json_data);
+    static std::string PublishBody(const std::string& client_id,
+                                   const std::string& topic,
+                                   const std::string& message);
 };
 
 } // namespace optimum_p2p
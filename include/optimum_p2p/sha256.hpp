@@ -0,0 +1,47 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// OpenSSL's EVP_MD_CTX, kept out of the public headers
+struct evp_md_ctx_st;
+
+namespace optimum_p2p {
+
+// Sha256Hasher computes SHA-256 incrementally over any number of buffers
+// using OpenSSL's EVP interface. The digest context is allocated once and
+// reused after every Final, so a hasher can be kept per thread and amortised
+// across messages. Not thread-safe.
+class Sha256Hasher {
+public:
+    static constexpr size_t kDigestSize = 32;
+    using Digest = std::array<uint8_t, kDigestSize>;
+    
+    Sha256Hasher();
+    ~Sha256Hasher();
+    
+    Sha256Hasher(const Sha256Hasher&) = delete;
+    Sha256Hasher& operator=(const Sha256Hasher&) = delete;
+    
+    // Discard any data hashed so far
+    void Reset();
+    
+    // Append data to the running hash
+    void Update(const void* data, size_t size);
+    void Update(std::string_view data) { Update(data.data(), data.size()); }
+    
+    // Finish the hash and reset for the next message.
+    // Returns false if OpenSSL failed to produce a digest.
+    bool Final(Digest& digest);
+    bool FinalHex(std::array<char, 2 * kDigestSize>& hex);
+    std::string FinalHex();
+
+private:
+    evp_md_ctx_st* ctx_;
+    bool ok_; // false once any EVP call has failed, until the next Reset
+};
+
+} // namespace optimum_p2p
@@ -2,6 +2,7 @@
 
 #include <cstdint>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace optimum_p2p {
@@ -22,6 +23,38 @@ enum class ResponseType : int32_t {
     MessageTraceGossipSub = 3
 };
 
+// PayloadEncoding selects how the envelope's Message field is interpreted.
+// The node's Go encoding/json emits []byte as padded base64; Auto decodes the
+// field only if it is valid padded base64 and otherwise keeps it as-is.
+enum class PayloadEncoding : int32_t {
+    Auto = 0,
+    Raw = 1,
+    Base64 = 2
+};
+
+// OverflowPolicy decides what happens to a received message when the client's
+// receive queue is full
+enum class OverflowPolicy : int32_t {
+    Block = 0,      // wait for room; the stream is not read meanwhile
+    DropOldest = 1, // evict the oldest queued message
+    DropNewest = 2  // discard the incoming message
+};
+
+// DispatchOrder selects the key callbacks are sharded by when a client hands
+// them to a DispatchPool; messages with the same key are delivered in order
+enum class DispatchOrder : int32_t {
+    PerTopic = 0,
+    PerSource = 1
+};
+
+// ReceiveQueueStats counts messages passing through a client's receive queue
+struct ReceiveQueueStats {
+    uint64_t queued = 0;
+    uint64_t dropped_oldest = 0;
+    uint64_t dropped_newest = 0;
+    size_t depth = 0; // messages currently waiting
+};
+
 // P2PMessage represents a message structure used in P2P communication
 struct P2PMessage {
     std::string message_id;
@@ -30,5 +63,24 @@ struct P2PMessage {
     std::string source_node_id;
 };
 
+// P2PMessageView is the zero-copy counterpart of P2PMessage. Its fields borrow
+// from the receive buffer and are only valid for the duration of the callback
+// they are passed to; call ToOwned() to keep the message beyond that.
+struct P2PMessageView {
+    std::string_view message_id;
+    std::string_view topic;
+    std::string_view message; // payload bytes
+    std::string_view source_node_id;
+    
+    P2PMessage ToOwned() const {
+        P2PMessage owned;
+        owned.message_id.assign(message_id.data(), message_id.size());
+        owned.topic.assign(topic.data(), topic.size());
+        owned.message.assign(message.begin(), message.end());
+        owned.source_node_id.assign(source_node_id.data(), source_node_id.size());
+        return owned;
+    }
+};
+
 } // namespace optimum_p2p
 
@@ -5,6 +5,9 @@
 #include <vector>
 #include <functional>
 #include <chrono>
+#include <memory>
+#include <string_view>
+#include <array>
 
 namespace optimum_p2p {
 
@@ -14,18 +17,61 @@ std::vector<std::string> ReadIPsFromFile(const std::string& filename);
 // Compute SHA256 hash and return as hex string
 std::string SHA256Hex(const std::vector<uint8_t>& data);
 
+// Non-allocating variant: writes the 64 hex digits into out (not NUL-terminated)
+void SHA256Hex(const uint8_t* data, size_t size, std::array<char, 64>& out);
+
+// Write 2 * size lowercase hex digits to out
+void HexEncode(const uint8_t* data, size_t size, char* out);
+
+// Bitcoin-alphabet base58, as used for libp2p peer IDs
+std::string Base58Encode(const uint8_t* data, size_t size);
+
 // Parse JSON message data into P2PMessage structure
-P2PMessage ParseMessage(const std::vector<uint8_t>& json_data);
+P2PMessage ParseMessage(const std::vector<uint8_t>& json_data,
+                        PayloadEncoding encoding = PayloadEncoding::Auto);
+P2PMessage ParseMessage(std::string_view json_data,
+                        PayloadEncoding encoding = PayloadEncoding::Auto);
+
+// Reusable decoder for the node's JSON message envelope. Views filled by
+// Decode point into json_data or into the decoder's internal storage, so they
+// stay valid while json_data is alive and until the next call to Decode.
+// Not thread-safe; keep one per receiving thread.
+class MessageDecoder {
+public:
+    MessageDecoder();
+    ~MessageDecoder();
+    
+    // Returns false (and an empty view) if json_data is not a valid envelope,
+    // or if encoding is Base64 and the Message field is not valid base64
+    bool Decode(std::string_view json_data, P2PMessageView& view,
+                PayloadEncoding encoding = PayloadEncoding::Auto);
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
 
-// Handle GossipSub trace events
+// Handle GossipSub trace events (serialized go-libp2p-pubsub TraceEvent).
+// With write_trace the callback gets a trace file line
+//   type\tpeerID\treceivedFrom\tmessageID\ttopic\ttimestamp
+// (peer IDs in base58, message ID in hex) and undecodable events are skipped;
+// otherwise it gets a readable summary, or a hex preview on decode errors.
 void HandleGossipSubTrace(const std::vector<uint8_t>& data, 
                          bool write_trace = false,
                          std::function<void(const std::string&)> trace_callback = nullptr);
+void HandleGossipSubTrace(std::string_view data,
+                         bool write_trace = false,
+                         std::function<void(const std::string&)> trace_callback = nullptr);
 
-// Handle mump2p trace events
+// Handle mump2p trace events (see DecodeMumP2PTrace). Same output as
+// HandleGossipSubTrace, with the numeric event type and empty receivedFrom
+// and topic columns.
 void HandleOptimumP2PTrace(const std::vector<uint8_t>& data,
                           bool write_trace = false,
                           std::function<void(const std::string&)> trace_callback = nullptr);
+void HandleOptimumP2PTrace(std::string_view data,
+                          bool write_trace = false,
+                          std::function<void(const std::string&)> trace_callback = nullptr);
 
 // Write data to file (used for output files)
 // Takes a callback that provides data lines until it returns empty string
@@ -0,0 +1,61 @@
+// Async completion-queue engine implementation
+
+#include "optimum_p2p/async_engine.hpp"
+#include <algorithm>
+
+namespace optimum_p2p {
+
+AsyncEngine::AsyncEngine(size_t num_threads)
+    : next_queue_(0), running_(true) {
+    if (num_threads == 0) {
+        num_threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    
+    for (size_t i = 0; i < num_threads; i++) {
+        queues_.push_back(std::make_unique<grpc::CompletionQueue>());
+    }
+    
+    for (auto& cq : queues_) {
+        grpc::CompletionQueue* queue = cq.get();
+        threads_.emplace_back([queue]() {
+            PollLoop(queue);
+        });
+    }
+}
+
+AsyncEngine::~AsyncEngine() {
+    Shutdown();
+}
+
+grpc::CompletionQueue* AsyncEngine::NextQueue() {
+    size_t index = next_queue_.fetch_add(1, std::memory_order_relaxed) % queues_.size();
+    return queues_[index].get();
+}
+
+void AsyncEngine::Shutdown() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+    
+    for (auto& cq : queues_) {
+        cq->Shutdown();
+    }
+    
+    // Poller threads exit once their queue is drained
+    for (auto& t : threads_) {
+        if (t.joinable()) {
+            t.join();
+        }
+    }
+}
+
+void AsyncEngine::PollLoop(grpc::CompletionQueue* cq) {
+    void* tag = nullptr;
+    bool ok = false;
+    
+    while (cq->Next(&tag, &ok)) {
+        static_cast<Operation*>(tag)->OnComplete(ok);
+    }
+}
+
+} // namespace optimum_p2p
@@ -0,0 +1,332 @@
+// Base64 decoder implementation
+//
+// The SIMD kernels classify and translate 16/32 input bytes at a time with
+// nibble lookup tables (pshufb), then pack four 6-bit values into three bytes
+// with two multiply-add steps. Any block containing a byte outside the
+// alphabet (including '=') is handed to the scalar decoder, which handles
+// padding, lenient skipping and error reporting.
+
+#include "optimum_p2p/base64.hpp"
+#include <array>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define OPTIMUM_P2P_BASE64_X86 1
+#include <immintrin.h>
+#endif
+
+namespace optimum_p2p {
+
+namespace {
+
+constexpr uint8_t kInvalid = 0xFF;
+constexpr uint8_t kPadding = 0xFE;
+
+constexpr std::array<uint8_t, 256> MakeDecodeTable() {
+    std::array<uint8_t, 256> table{};
+    for (auto& v : table) {
+        v = kInvalid;
+    }
+    
+    const char* alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    for (uint8_t i = 0; i < 64; i++) {
+        table[static_cast<uint8_t>(alphabet[i])] = i;
+    }
+    table['='] = kPadding;
+    return table;
+}
+
+constexpr std::array<uint8_t, 256> kDecodeTable = MakeDecodeTable();
+
+// Decode whole quanta while all four bytes are in the alphabet
+void DecodeScalarQuanta(const uint8_t*& src, const uint8_t* end, uint8_t*& dst) {
+    while (end - src >= 4) {
+        uint32_t a = kDecodeTable[src[0]];
+        uint32_t b = kDecodeTable[src[1]];
+        uint32_t c = kDecodeTable[src[2]];
+        uint32_t d = kDecodeTable[src[3]];
+        
+        if ((a | b | c | d) & 0x80) {
+            return;
+        }
+        
+        uint32_t triple = (a << 18) | (b << 12) | (c << 6) | d;
+        dst[0] = static_cast<uint8_t>(triple >> 16);
+        dst[1] = static_cast<uint8_t>(triple >> 8);
+        dst[2] = static_cast<uint8_t>(triple);
+        src += 4;
+        dst += 3;
+    }
+}
+
+// Historical semantics: skip bytes outside the alphabet, stop at the first '='
+void DecodeLenientTail(const uint8_t* src, const uint8_t* end, uint8_t*& dst) {
+    uint32_t bits = 0;
+    int nbits = 0;
+    
+    for (; src < end; src++) {
+        uint8_t v = kDecodeTable[*src];
+        if (v == kPadding) {
+            break;
+        }
+        if (v == kInvalid) {
+            continue;
+        }
+        
+        bits = (bits << 6) | v;
+        nbits += 6;
+        if (nbits >= 8) {
+            nbits -= 8;
+            *dst++ = static_cast<uint8_t>(bits >> nbits);
+            bits &= (1u << nbits) - 1;
+        }
+    }
+}
+
+// Strict tail: src is quantum aligned and end - src is a multiple of 4.
+// Decodes the remaining quanta, accepting "xx==" / "xxx=" only as the last one
+// and only with the unused low bits zero.
+Base64Status DecodeStrictTail(const uint8_t*& src, const uint8_t* end, uint8_t*& dst) {
+    while (src < end) {
+        DecodeScalarQuanta(src, end, dst);
+        if (src == end) {
+            break;
+        }
+        
+        uint8_t v[4];
+        for (int i = 0; i < 4; i++) {
+            v[i] = kDecodeTable[src[i]];
+            if (v[i] == kInvalid) {
+                src += i;
+                return Base64Status::InvalidCharacter;
+            }
+        }
+        
+        // The quantum holds at least one '='; it must be the last one
+        bool last = (end - src == 4);
+        for (int i = 0; i < 2; i++) {
+            if (v[i] == kPadding) {
+                src += i;
+                return Base64Status::InvalidPadding;
+            }
+        }
+        if (v[2] == kPadding && v[3] != kPadding) {
+            src += 2;
+            return Base64Status::InvalidPadding;
+        }
+        if (!last) {
+            src += (v[2] == kPadding) ? 2 : 3;
+            return Base64Status::InvalidPadding;
+        }
+        
+        // Canonical encoders zero the bits the padding leaves unused
+        if (v[2] == kPadding ? (v[1] & 0x0F) : (v[2] & 0x03)) {
+            src += (v[2] == kPadding) ? 1 : 2;
+            return Base64Status::NonCanonical;
+        }
+        
+        uint32_t triple = (uint32_t(v[0]) << 18) | (uint32_t(v[1]) << 12);
+        *dst++ = static_cast<uint8_t>(triple >> 16);
+        if (v[2] != kPadding) {
+            triple |= uint32_t(v[2]) << 6;
+            *dst++ = static_cast<uint8_t>(triple >> 8);
+        }
+        src += 4;
+    }
+    return Base64Status::Ok;
+}
+
+#ifdef OPTIMUM_P2P_BASE64_X86
+
+// Each kernel stops while the remaining input still guarantees room for its
+// full-width store: a block of N input bytes yields 3N/4 output bytes but the
+// store writes 16 (SSE) or 32 (AVX2) bytes.
+
+__attribute__((target("ssse3,sse4.1")))
+void DecodeSSE41(const uint8_t*& src, const uint8_t* end, uint8_t*& dst) {
+    const __m128i lut_lo = _mm_setr_epi8(
+        0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+        0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+    const __m128i lut_hi = _mm_setr_epi8(
+        0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+        0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+    const __m128i lut_roll = _mm_setr_epi8(
+        0, 16, 19, 4, -65, -65, -71, -71,
+        0, 0, 0, 0, 0, 0, 0, 0);
+    const __m128i mask_2f = _mm_set1_epi8(0x2f);
+    const __m128i merge_pairs = _mm_set1_epi32(0x01400140);
+    const __m128i merge_quads = _mm_set1_epi32(0x00011000);
+    const __m128i pack = _mm_setr_epi8(
+        2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+    
+    while (end - src >= 24) {
+        __m128i str = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+        
+        __m128i hi_nibbles = _mm_and_si128(_mm_srli_epi32(str, 4), mask_2f);
+        __m128i lo_nibbles = _mm_and_si128(str, mask_2f);
+        __m128i hi = _mm_shuffle_epi8(lut_hi, hi_nibbles);
+        __m128i lo = _mm_shuffle_epi8(lut_lo, lo_nibbles);
+        if (!_mm_testz_si128(lo, hi)) {
+            break;
+        }
+        
+        __m128i eq_2f = _mm_cmpeq_epi8(str, mask_2f);
+        __m128i roll = _mm_shuffle_epi8(lut_roll, _mm_add_epi8(eq_2f, hi_nibbles));
+        str = _mm_add_epi8(str, roll);
+        
+        str = _mm_maddubs_epi16(str, merge_pairs);
+        str = _mm_madd_epi16(str, merge_quads);
+        str = _mm_shuffle_epi8(str, pack);
+        
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), str);
+        src += 16;
+        dst += 12;
+    }
+}
+
+__attribute__((target("avx2")))
+void DecodeAVX2(const uint8_t*& src, const uint8_t* end, uint8_t*& dst) {
+    const __m256i lut_lo = _mm256_setr_epi8(
+        0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+        0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A,
+        0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+        0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+    const __m256i lut_hi = _mm256_setr_epi8(
+        0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+        0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+        0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+        0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+    const __m256i lut_roll = _mm256_setr_epi8(
+        0, 16, 19, 4, -65, -65, -71, -71,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        0, 16, 19, 4, -65, -65, -71, -71,
+        0, 0, 0, 0, 0, 0, 0, 0);
+    const __m256i mask_2f = _mm256_set1_epi8(0x2f);
+    const __m256i merge_pairs = _mm256_set1_epi32(0x01400140);
+    const __m256i merge_quads = _mm256_set1_epi32(0x00011000);
+    const __m256i pack = _mm256_setr_epi8(
+        2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+        2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+    const __m256i lanes = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, -1, -1);
+    
+    while (end - src >= 44) {
+        __m256i str = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src));
+        
+        __m256i hi_nibbles = _mm256_and_si256(_mm256_srli_epi32(str, 4), mask_2f);
+        __m256i lo_nibbles = _mm256_and_si256(str, mask_2f);
+        __m256i hi = _mm256_shuffle_epi8(lut_hi, hi_nibbles);
+        __m256i lo = _mm256_shuffle_epi8(lut_lo, lo_nibbles);
+        if (!_mm256_testz_si256(lo, hi)) {
+            break;
+        }
+        
+        __m256i eq_2f = _mm256_cmpeq_epi8(str, mask_2f);
+        __m256i roll = _mm256_shuffle_epi8(lut_roll, _mm256_add_epi8(eq_2f, hi_nibbles));
+        str = _mm256_add_epi8(str, roll);
+        
+        str = _mm256_maddubs_epi16(str, merge_pairs);
+        str = _mm256_madd_epi16(str, merge_quads);
+        str = _mm256_shuffle_epi8(str, pack);
+        str = _mm256_permutevar8x32_epi32(str, lanes);
+        
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst), str);
+        src += 32;
+        dst += 24;
+    }
+    
+    // Finish with 16-byte blocks before the scalar tail
+    DecodeSSE41(src, end, dst);
+}
+
+#endif // OPTIMUM_P2P_BASE64_X86
+
+Base64Kernel DetectKernel() {
+#ifdef OPTIMUM_P2P_BASE64_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return Base64Kernel::AVX2;
+    }
+    if (__builtin_cpu_supports("sse4.1")) {
+        return Base64Kernel::SSE41;
+    }
+#endif
+    return Base64Kernel::Scalar;
+}
+
+// Clamp a requested kernel to what the CPU supports
+Base64Kernel ResolveKernel(Base64Kernel requested) {
+    Base64Kernel active = Base64ActiveKernel();
+    if (requested == Base64Kernel::Auto) {
+        return active;
+    }
+    return static_cast<int>(requested) <= static_cast<int>(active) ? requested : Base64Kernel::Scalar;
+}
+
+} // namespace
+
+Base64Kernel Base64ActiveKernel() {
+    static const Base64Kernel kernel = DetectKernel();
+    return kernel;
+}
+
+const char* Base64KernelName(Base64Kernel kernel) {
+    switch (kernel) {
+        case Base64Kernel::Auto:
+            return "auto";
+        case Base64Kernel::Scalar:
+            return "scalar";
+        case Base64Kernel::SSE41:
+            return "sse4.1";
+        case Base64Kernel::AVX2:
+            return "avx2";
+    }
+    return "unknown";
+}
+
+Base64Result Base64Decode(std::string_view input, uint8_t* out, bool strict, Base64Kernel kernel) {
+    Base64Result result;
+    const uint8_t* begin = reinterpret_cast<const uint8_t*>(input.data());
+    const uint8_t* src = begin;
+    const uint8_t* end = begin + input.size();
+    uint8_t* dst = out;
+    
+    if (strict && input.size() % 4 != 0) {
+        result.status = Base64Status::InvalidLength;
+        result.error_offset = input.size();
+        return result;
+    }
+    
+    switch (ResolveKernel(kernel)) {
+#ifdef OPTIMUM_P2P_BASE64_X86
+        case Base64Kernel::AVX2:
+            DecodeAVX2(src, end, dst);
+            break;
+        case Base64Kernel::SSE41:
+            DecodeSSE41(src, end, dst);
+            break;
+#endif
+        default:
+            break;
+    }
+    
+    if (strict) {
+        result.status = DecodeStrictTail(src, end, dst);
+        if (result.status != Base64Status::Ok) {
+            result.error_offset = static_cast<size_t>(src - begin);
+        }
+    } else {
+        DecodeScalarQuanta(src, end, dst);
+        DecodeLenientTail(src, end, dst);
+    }
+    
+    result.written = static_cast<size_t>(dst - out);
+    return result;
+}
+
+Base64Status Base64Decode(std::string_view input, std::vector<uint8_t>& out, bool strict) {
+    out.resize(Base64DecodedMaxSize(input.size()));
+    Base64Result result = Base64Decode(input, out.data(), strict);
+    out.resize(result.written);
+    return result.status;
+}
+
+} // namespace optimum_p2p
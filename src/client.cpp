@@ -4,33 +4,289 @@
 #include "optimum_p2p/utils.hpp"
 #include <grpcpp/create_channel.h>
 #include <grpcpp/security/credentials.h>
+#include <google/protobuf/arena.h>
+#include <algorithm>
 #include <chrono>
 #include <mutex>
 #include <queue>
+#include <deque>
+#include <future>
+#include <condition_variable>
 #include <climits>
 #include <thread>
 
 namespace optimum_p2p {
 
-P2PClient::P2PClient(const std::string& address) 
-    : running_(true) {
-    // Create channel arguments with max message sizes (like Go's MaxCallRecvMsgSize/MaxCallSendMsgSize)
-    grpc::ChannelArguments args;
-    args.SetMaxReceiveMessageSize(INT_MAX);
-    args.SetMaxSendMessageSize(INT_MAX);
+// AsyncStream drives the ListenCommands stream of an async-mode client through
+// one of the engine's completion queues. gRPC allows a single outstanding read
+// and a single outstanding write per stream, so the read is re-armed after each
+// completion and writes are queued and issued one at a time.
+class P2PClient::AsyncStream {
+public:
+    AsyncStream(P2PClient* client, grpc::CompletionQueue* cq, size_t capacity);
     
-    // Create insecure channel (like Go's insecure.NewCredentials())
-    channel_ = grpc::CreateCustomChannel(address, grpc::InsecureChannelCredentials(), args);
+    // Queue a write (moved from on success); its promise is completed once the
+    // write finishes. With block, waits for room when capacity writes are
+    // outstanding; otherwise returns false. Also false once the call is dead.
+    bool Write(PendingWrite& write, bool block);
     
-    if (!channel_) {
-        running_ = false;
+    void SetCapacity(size_t capacity);
+    
+    // Write out queued requests and half-close the stream, then wait until every
+    // outstanding operation has completed. The call is cancelled if the node
+    // has not closed the stream within the grace period.
+    void Shutdown(std::chrono::milliseconds grace_period);
+
+private:
+    // Completion-queue tag dispatching to a member handler
+    class Tag : public AsyncEngine::Operation {
+    public:
+        Tag(AsyncStream* stream, void (AsyncStream::*handler)(bool))
+            : stream_(stream), handler_(handler) {}
+        
+        void OnComplete(bool ok) override {
+            (stream_->*handler_)(ok);
+        }
+    
+    private:
+        AsyncStream* stream_;
+        void (AsyncStream::*handler_)(bool);
+    };
+    
+    void OnStart(bool ok);
+    void OnRead(bool ok);
+    void OnWrite(bool ok);
+    void OnWritesDone(bool ok);
+    void OnFinish(bool ok);
+    
+    void StartWriteLocked();
+    void FailWritesLocked();
+    void MaybeFinishLocked();
+    
+    P2PClient* client_;
+    std::unique_ptr<grpc::ClientAsyncReaderWriter<proto::Request, proto::Response>> stream_;
+    proto::Response response_;
+    grpc::Status status_;
+    
+    Tag start_tag_;
+    Tag read_tag_;
+    Tag write_tag_;
+    Tag writes_done_tag_;
+    Tag finish_tag_;
+    
+    std::mutex mutex_;
+    std::deque<PendingWrite> writes_; // front is in flight while writing_
+    std::condition_variable space_;   // signalled when writes_ shrinks
+    size_t capacity_;
+    bool started_;
+    bool reading_;
+    bool writing_;
+    bool closed_;    // call is dead, no new reads or writes are issued
+    bool half_closing_; // Shutdown requested, WritesDone follows the last write
+    bool writes_done_;
+    bool finishing_;
+    std::promise<void> finished_;
+    std::future<void> finished_future_;
+};
+
+P2PClient::AsyncStream::AsyncStream(P2PClient* client, grpc::CompletionQueue* cq, size_t capacity)
+    : client_(client),
+      start_tag_(this, &AsyncStream::OnStart),
+      read_tag_(this, &AsyncStream::OnRead),
+      write_tag_(this, &AsyncStream::OnWrite),
+      writes_done_tag_(this, &AsyncStream::OnWritesDone),
+      finish_tag_(this, &AsyncStream::OnFinish),
+      capacity_(capacity > 0 ? capacity : 1),
+      started_(false),
+      reading_(false),
+      writing_(false),
+      closed_(false),
+      half_closing_(false),
+      writes_done_(false),
+      finishing_(false),
+      finished_future_(finished_.get_future()) {
+    stream_ = client_->stub_->PrepareAsyncListenCommands(client_->context_.get(), cq);
+    stream_->StartCall(&start_tag_);
+}
+
+bool P2PClient::AsyncStream::Write(PendingWrite& write, bool block) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    
+    if (block) {
+        space_.wait(lock, [this]() { return closed_ || half_closing_ || writes_.size() < capacity_; });
+    }
+    if (closed_ || half_closing_ || writes_.size() >= capacity_) {
+        return false;
+    }
+    
+    writes_.push_back(std::move(write));
+    if (started_) {
+        StartWriteLocked();
+    }
+    
+    return true;
+}
+
+void P2PClient::AsyncStream::SetCapacity(size_t capacity) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    capacity_ = capacity > 0 ? capacity : 1;
+    space_.notify_all();
+}
+
+void P2PClient::AsyncStream::Shutdown(std::chrono::milliseconds grace_period) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        half_closing_ = true;
+        space_.notify_all();
+        if (started_) {
+            StartWriteLocked();
+        }
+    }
+    
+    // Cancellation fails the pending read (and any write), which leads to Finish
+    if (finished_future_.wait_for(grace_period) != std::future_status::ready) {
+        client_->context_->TryCancel();
+        finished_future_.wait();
+    }
+}
+
+void P2PClient::AsyncStream::OnStart(bool ok) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    started_ = true;
+    
+    if (!ok) {
+        closed_ = true;
+        FailWritesLocked();
+        MaybeFinishLocked();
         return;
     }
     
-    // Create stub
-    stub_ = proto::CommandStream::NewStub(channel_);
+    reading_ = true;
+    stream_->Read(&response_, &read_tag_);
+    StartWriteLocked();
+}
+
+void P2PClient::AsyncStream::OnRead(bool ok) {
+    // Like ReceiveLoop, messages read after Shutdown has begun are discarded
+    if (ok && client_->running_) {
+        client_->HandleResponse(response_);
+    }
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    if (ok && !closed_) {
+        stream_->Read(&response_, &read_tag_);
+        return;
+    }
+    
+    // Stream closed or error
+    reading_ = false;
+    closed_ = true;
+    FailWritesLocked();
+    MaybeFinishLocked();
+}
+
+void P2PClient::AsyncStream::OnWrite(bool ok) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    writing_ = false;
+    
+    writes_.front().done.set_value(ok);
+    writes_.pop_front();
+    space_.notify_one();
+    
+    if (!ok) {
+        // A failed write means the call is dead; make sure the read fails too
+        closed_ = true;
+        FailWritesLocked();
+        client_->context_->TryCancel();
+    } else {
+        StartWriteLocked();
+    }
+    
+    MaybeFinishLocked();
+}
+
+void P2PClient::AsyncStream::OnWritesDone(bool ok) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    writing_ = false;
+    
+    if (!ok) {
+        closed_ = true;
+        client_->context_->TryCancel();
+    }
+    
+    // The node ends the stream after the half-close, which fails the read
+    MaybeFinishLocked();
+}
+
+void P2PClient::AsyncStream::OnFinish(bool /*ok*/) {
+    finished_.set_value();
+}
+
+void P2PClient::AsyncStream::StartWriteLocked() {
+    if (writing_ || closed_) {
+        return;
+    }
+    
+    if (!writes_.empty()) {
+        writing_ = true;
+        stream_->Write(writes_.front().request, writes_.front().options, &write_tag_);
+    } else if (half_closing_ && !writes_done_) {
+        writes_done_ = true;
+        writing_ = true;
+        stream_->WritesDone(&writes_done_tag_);
+    }
+}
+
+void P2PClient::AsyncStream::FailWritesLocked() {
+    // Keep the in-flight entry, its completion is still pending
+    size_t keep = writing_ ? 1 : 0;
+    while (writes_.size() > keep) {
+        writes_.back().done.set_value(false);
+        writes_.pop_back();
+    }
+    space_.notify_all();
+}
+
+void P2PClient::AsyncStream::MaybeFinishLocked() {
+    if (!closed_ || reading_ || writing_ || finishing_) {
+        return;
+    }
     
-    if (!stub_) {
+    finishing_ = true;
+    stream_->Finish(&status_, &finish_tag_);
+}
+
+// Default bound on queued, not yet written messages per client
+static constexpr size_t kDefaultSendQueueDepth = 1024;
+
+// Default bound on received messages waiting for ReceiveMessage
+static constexpr size_t kDefaultReceiveQueueDepth = 1024;
+
+// The reused request is rebuilt after carrying a payload larger than this
+static constexpr size_t kMaxRetainedRequestBytes = 1024 * 1024;
+
+// How long an async-mode Shutdown waits for the node to close the stream
+static constexpr std::chrono::milliseconds kShutdownGracePeriod(2000);
+
+P2PClient::P2PClient(const std::string& address) 
+    : request_(nullptr),
+      send_queue_(kDefaultSendQueueDepth),
+      send_thread_started_(false),
+      running_(true),
+      payload_encoding_(PayloadEncoding::Auto),
+      receive_queue_(kDefaultReceiveQueueDepth),
+      receive_policy_(OverflowPolicy::Block),
+      received_queued_(0),
+      received_dropped_oldest_(0),
+      received_dropped_newest_(0),
+      receive_consumer_(false),
+      decode_failures_(0),
+      dispatch_order_(DispatchOrder::PerTopic),
+      dispatch_pending_(0),
+      trace_sample_rate_(1.0),
+      trace_sample_credit_(0.0) {
+    if (!Connect(address)) {
         running_ = false;
         return;
     }
@@ -51,69 +307,386 @@ P2PClient::P2PClient(const std::string& address)
     });
 }
 
+P2PClient::P2PClient(const std::string& address, std::shared_ptr<AsyncEngine> engine)
+    : request_(nullptr),
+      send_queue_(kDefaultSendQueueDepth),
+      send_thread_started_(false),
+      running_(true),
+      payload_encoding_(PayloadEncoding::Auto),
+      receive_queue_(kDefaultReceiveQueueDepth),
+      receive_policy_(OverflowPolicy::DropOldest),
+      received_queued_(0),
+      received_dropped_oldest_(0),
+      received_dropped_newest_(0),
+      receive_consumer_(false),
+      decode_failures_(0),
+      engine_(std::move(engine)),
+      dispatch_order_(DispatchOrder::PerTopic),
+      dispatch_pending_(0),
+      trace_sample_rate_(1.0),
+      trace_sample_credit_(0.0) {
+    if (!engine_ || !Connect(address)) {
+        running_ = false;
+        return;
+    }
+    
+    // Create bidirectional stream, driven by one of the engine's pollers
+    context_ = std::make_unique<grpc::ClientContext>();
+    async_stream_ = std::make_unique<AsyncStream>(this, engine_->NextQueue(), kDefaultSendQueueDepth);
+}
+
 P2PClient::~P2PClient() {
     Shutdown();
 }
 
-bool P2PClient::Subscribe(const std::string& topic) {
-    if (!stream_ || !running_) {
+bool P2PClient::Connect(const std::string& address) {
+    // Create channel arguments with max message sizes (like Go's MaxCallRecvMsgSize/MaxCallSendMsgSize)
+    grpc::ChannelArguments args;
+    args.SetMaxReceiveMessageSize(INT_MAX);
+    args.SetMaxSendMessageSize(INT_MAX);
+    
+    // Create insecure channel (like Go's insecure.NewCredentials())
+    channel_ = grpc::CreateCustomChannel(address, grpc::InsecureChannelCredentials(), args);
+    
+    if (!channel_) {
         return false;
     }
     
-    proto::Request request;
-    request.set_command(static_cast<int32_t>(Command::SubscribeToTopic));
-    request.set_topic(topic);
+    // Create stub
+    stub_ = proto::CommandStream::NewStub(channel_);
+    
+    return stub_ != nullptr;
+}
+
+bool P2PClient::Subscribe(const std::string& topic) {
+    if ((!stream_ && !async_stream_) || !running_) {
+        return false;
+    }
     
-    return stream_->Write(request);
+    return Write(Command::SubscribeToTopic, topic, nullptr, 0);
 }
 
 bool P2PClient::Publish(const std::string& topic, const std::vector<uint8_t>& data) {
-    if (!stream_ || !running_) {
+    if ((!stream_ && !async_stream_) || !running_) {
         return false;
     }
     
+    return Write(Command::PublishData, topic, data.data(), data.size());
+}
+
+std::future<bool> P2PClient::PublishAsync(const std::string& topic, const std::vector<uint8_t>& data) {
+    PendingWrite write;
+    std::future<bool> result = write.done.get_future();
+    
+    if ((!stream_ && !async_stream_) || !running_) {
+        write.done.set_value(false);
+        return result;
+    }
+    
+    write.request = MakePublishRequest(topic, data);
+    if (!Enqueue(write, true)) {
+        write.done.set_value(false);
+    }
+    return result;
+}
+
+bool P2PClient::TryPublishAsync(const std::string& topic,
+                                const std::vector<uint8_t>& data,
+                                std::future<bool>& result) {
+    if ((!stream_ && !async_stream_) || !running_) {
+        return false;
+    }
+    
+    PendingWrite write;
+    std::future<bool> done = write.done.get_future();
+    write.request = MakePublishRequest(topic, data);
+    if (!Enqueue(write, false)) {
+        return false;
+    }
+    
+    result = std::move(done);
+    return true;
+}
+
+std::vector<bool> P2PClient::PublishBatch(const std::string& topic,
+                                          const std::vector<std::vector<uint8_t>>& payloads) {
+    std::vector<bool> results(payloads.size(), false);
+    if ((!stream_ && !async_stream_) || !running_ || payloads.empty()) {
+        return results;
+    }
+    
+    // Queued writes own their requests; keep the batch in order behind them
+    if (async_stream_ || send_thread_started_) {
+        std::vector<std::future<bool>> done;
+        done.reserve(payloads.size());
+        
+        for (size_t i = 0; i < payloads.size(); i++) {
+            PendingWrite write;
+            done.push_back(write.done.get_future());
+            write.request = MakePublishRequest(topic, payloads[i]);
+            if (i + 1 < payloads.size()) {
+                write.options.set_buffer_hint();
+            }
+            if (!Enqueue(write, true)) {
+                write.done.set_value(false);
+            }
+        }
+        
+        for (size_t i = 0; i < done.size(); i++) {
+            results[i] = done[i].get();
+        }
+        return results;
+    }
+    
+    // Direct writes refill the client's reused request, the topic is set once.
+    // Checked again under the lock: Shutdown half-closes the stream holding it.
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    if (!running_) {
+        return results;
+    }
+    proto::Request* request = ReusableRequestLocked();
+    request->set_command(static_cast<int32_t>(Command::PublishData));
+    request->set_topic(topic);
+    
+    for (size_t i = 0; i < payloads.size(); i++) {
+        request->set_data(payloads[i].data(), payloads[i].size());
+        
+        grpc::WriteOptions options;
+        if (i + 1 < payloads.size()) {
+            options.set_buffer_hint();
+        }
+        
+        results[i] = stream_->Write(*request, options);
+        if (!results[i]) {
+            break; // the stream is dead, the rest fail too
+        }
+    }
+    
+    return results;
+}
+
+void P2PClient::SetSendQueueDepth(size_t depth) {
+    send_queue_.SetCapacity(depth);
+    if (async_stream_) {
+        async_stream_->SetCapacity(depth);
+    }
+}
+
+proto::Request P2PClient::MakePublishRequest(const std::string& topic, const std::vector<uint8_t>& data) {
     proto::Request request;
     request.set_command(static_cast<int32_t>(Command::PublishData));
     request.set_topic(topic);
     request.set_data(data.data(), data.size());
-    
-    return stream_->Write(request);
+    return request;
 }
 
-bool P2PClient::ReceiveMessage(P2PMessage& message, std::chrono::milliseconds timeout) {
-    // This is a blocking receive - for non-blocking, use SetMessageCallback
-    if (!stream_ || !running_) {
-        return false;
+bool P2PClient::Write(Command command, const std::string& topic, const uint8_t* data, size_t size) {
+    // Once the writer thread exists every write goes through the queue to keep order
+    if (async_stream_ || send_thread_started_) {
+        PendingWrite write;
+        std::future<bool> done = write.done.get_future();
+        write.request.set_command(static_cast<int32_t>(command));
+        write.request.set_topic(topic);
+        write.request.set_data(data, size);
+        if (!Enqueue(write, true)) {
+            return false;
+        }
+        return done.get();
     }
     
-    proto::Response response;
-    if (!stream_->Read(&response)) {
+    // Direct writes reuse one request, so steady-state publishing does not
+    // allocate. No write may follow Shutdown's WritesDone.
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    if (!running_) {
         return false;
     }
+    proto::Request* request = ReusableRequestLocked();
+    request->set_command(static_cast<int32_t>(command));
+    request->set_topic(topic);
+    request->set_data(data, size);
+    return stream_->Write(*request);
+}
+
+proto::Request* P2PClient::ReusableRequestLocked() {
+    // Release the buffers of an oversized payload instead of keeping them for good
+    if (request_ && request_->data().capacity() > kMaxRetainedRequestBytes) {
+        request_ = nullptr;
+        request_arena_.Reset();
+    }
     
-    // Parse response based on type
-    if (response.command() == proto::ResponseType::Message) {
-        std::vector<uint8_t> json_data(response.data().begin(), response.data().end());
-        message = ParseMessage(json_data);
-        return true;
+    if (!request_) {
+        request_ = google::protobuf::Arena::CreateMessage<proto::Request>(&request_arena_);
+    }
+    return request_;
+}
+
+bool P2PClient::Enqueue(PendingWrite& write, bool block) {
+    if (async_stream_) {
+        return async_stream_->Write(write, block);
+    }
+    
+    // Started under the lock Shutdown closes the queue with, so a write racing
+    // Shutdown cannot leave a thread behind that nobody joins
+    if (!send_thread_started_) {
+        std::lock_guard<std::mutex> lock(send_thread_mutex_);
+        if (!running_) {
+            return false;
+        }
+        if (!send_thread_started_) {
+            send_thread_ = std::thread([this]() {
+                this->SendLoop();
+            });
+            send_thread_started_ = true;
+        }
     }
     
-    return false;
+    return block ? send_queue_.Push(std::move(write)) : send_queue_.TryPush(std::move(write));
+}
+
+void P2PClient::SendLoop() {
+    PendingWrite write;
+    
+    while (send_queue_.Pop(write)) {
+        bool ok;
+        {
+            std::lock_guard<std::mutex> lock(write_mutex_);
+            ok = stream_->Write(write.request, write.options);
+        }
+        write.done.set_value(ok);
+        write = PendingWrite();
+    }
+}
+
+bool P2PClient::ReceiveMessage(P2PMessage& message, std::chrono::milliseconds timeout) {
+    receive_consumer_ = true;
+    
+    // The receive thread (or poller) is the only reader of the stream; this
+    // just waits on what it has queued
+    return receive_queue_.PopFor(message, std::max(timeout, std::chrono::milliseconds(0)));
+}
+
+size_t P2PClient::ReceiveBatch(std::vector<P2PMessage>& out, size_t max, std::chrono::milliseconds timeout) {
+    receive_consumer_ = true;
+    if (max == 0) {
+        return 0;
+    }
+    return receive_queue_.PopBatch(out, max, std::max(timeout, std::chrono::milliseconds(0)));
+}
+
+void P2PClient::SetReceiveQueueDepth(size_t depth) {
+    receive_queue_.SetCapacity(depth);
+}
+
+void P2PClient::SetReceiveOverflowPolicy(OverflowPolicy policy) {
+    receive_policy_ = policy;
+}
+
+ReceiveQueueStats P2PClient::GetReceiveQueueStats() const {
+    ReceiveQueueStats stats;
+    stats.queued = received_queued_.load(std::memory_order_relaxed);
+    stats.dropped_oldest = received_dropped_oldest_.load(std::memory_order_relaxed);
+    stats.dropped_newest = received_dropped_newest_.load(std::memory_order_relaxed);
+    stats.depth = receive_queue_.Size();
+    return stats;
+}
+
+uint64_t P2PClient::GetDecodeFailures() const {
+    return decode_failures_.load(std::memory_order_relaxed);
+}
+
+void P2PClient::QueueReceived(P2PMessage message) {
+    bool queued = false;
+    
+    // Nobody drains the queue yet: keep the newest messages without blocking
+    OverflowPolicy policy = receive_consumer_.load(std::memory_order_relaxed)
+                                ? receive_policy_.load(std::memory_order_relaxed)
+                                : OverflowPolicy::DropOldest;
+    
+    switch (policy) {
+    case OverflowPolicy::Block:
+        queued = receive_queue_.Push(std::move(message));
+        break;
+    case OverflowPolicy::DropOldest: {
+        size_t dropped = 0;
+        queued = receive_queue_.PushDropOldest(std::move(message), dropped);
+        received_dropped_oldest_.fetch_add(dropped, std::memory_order_relaxed);
+        break;
+    }
+    case OverflowPolicy::DropNewest:
+        queued = receive_queue_.TryPush(std::move(message));
+        if (!queued && running_) {
+            received_dropped_newest_.fetch_add(1, std::memory_order_relaxed);
+        }
+        break;
+    }
+    
+    if (queued) {
+        received_queued_.fetch_add(1, std::memory_order_relaxed);
+    }
 }
 
 void P2PClient::SetMessageCallback(std::function<void(const P2PMessage&)> callback) {
     message_callback_ = callback;
 }
 
+void P2PClient::SetMessageViewCallback(std::function<void(const P2PMessageView&)> callback) {
+    message_view_callback_ = callback;
+}
+
+void P2PClient::SetDispatchPool(std::shared_ptr<DispatchPool> pool, DispatchOrder order) {
+    dispatch_pool_ = std::move(pool);
+    dispatch_order_ = order;
+}
+
+void P2PClient::SetTraceCallback(std::function<void(ResponseType type, std::string_view event)> callback) {
+    trace_callback_ = callback;
+}
+
+void P2PClient::SetTraceSampleRate(double rate) {
+    trace_sample_rate_ = std::min(std::max(rate, 0.0), 1.0);
+}
+
+void P2PClient::SetGossipSubAggregator(std::shared_ptr<GossipSubTraceAggregator> aggregator) {
+    gossipsub_aggregator_ = std::move(aggregator);
+}
+
+void P2PClient::SetPropagationTracker(std::shared_ptr<PropagationTracker> tracker) {
+    propagation_tracker_ = std::move(tracker);
+}
+
+void P2PClient::SetPayloadEncoding(PayloadEncoding encoding) {
+    payload_encoding_ = encoding;
+}
+
 void P2PClient::Shutdown() {
-    if (!running_) {
+    // Only the first caller shuts down
+    if (!running_.exchange(false)) {
         return;
     }
     
-    running_ = false;
+    // Release a receive thread blocked on a full receive queue; what is
+    // queued can still be drained
+    receive_queue_.Close();
     
-    // Close write side of stream
+    // Write out what is still queued before half-closing the stream. Once the
+    // lock is released no write can start the writer thread any more.
+    {
+        std::lock_guard<std::mutex> lock(send_thread_mutex_);
+        send_queue_.Close();
+    }
+    if (send_thread_.joinable()) {
+        send_thread_.join();
+    }
+    
+    // Async mode: cancel the call and wait for the poller to release it
+    if (async_stream_) {
+        async_stream_->Shutdown(kShutdownGracePeriod);
+        async_stream_.reset();
+    }
+    
+    // Close write side of stream, after any direct write still in progress
     if (stream_) {
+        std::lock_guard<std::mutex> lock(write_mutex_);
         stream_->WritesDone();
     }
     
@@ -128,6 +701,12 @@ void P2PClient::Shutdown() {
         stream_.reset();
     }
     
+    // Nothing is read any more; wait for queued callbacks, they use this client
+    {
+        std::unique_lock<std::mutex> lock(dispatch_mutex_);
+        dispatch_idle_.wait(lock, [this]() { return dispatch_pending_.load() == 0; });
+    }
+    
     // Clean up context, stub and channel
     context_.reset();
     stub_.reset();
@@ -137,28 +716,108 @@ void P2PClient::Shutdown() {
 void P2PClient::ReceiveLoop() {
     proto::Response response;
     
-    while (running_) {
-        if (!stream_->Read(&response)) {
-            // Stream closed or error
-            break;
+    // Read until the stream ends (closed or error). Finish needs every message
+    // read, so after Shutdown the rest is read and discarded.
+    while (stream_->Read(&response)) {
+        if (running_) {
+            HandleResponse(response);
+        }
+    }
+}
+
+void P2PClient::HandleResponse(const proto::Response& response) {
+    // Handle different response types
+    if (response.command() == proto::ResponseType::Message) {
+        // Decode in place; the view borrows from the response and the decoder
+        P2PMessageView view;
+        if (!decoder_.Decode(response.data(), view, payload_encoding_.load(std::memory_order_relaxed))) {
+            decode_failures_.fetch_add(1, std::memory_order_relaxed);
+            return;
         }
         
-        // Handle different response types
-        if (response.command() == proto::ResponseType::Message) {
-            std::vector<uint8_t> json_data(response.data().begin(), response.data().end());
-            P2PMessage msg = ParseMessage(json_data);
-            
-            // Call callback if set
-            if (message_callback_) {
-                message_callback_(msg);
-            }
-        } else if (response.command() == proto::ResponseType::MessageTraceGossipSub) {
-            std::vector<uint8_t> trace_data(response.data().begin(), response.data().end());
-            HandleGossipSubTrace(trace_data, false, nullptr);
-        } else if (response.command() == proto::ResponseType::MessageTraceMumP2P) {
-            std::vector<uint8_t> trace_data(response.data().begin(), response.data().end());
-            HandleOptimumP2PTrace(trace_data, false, nullptr);
+        // Without callbacks the message waits for ReceiveMessage/ReceiveBatch
+        if (!message_view_callback_ && !message_callback_) {
+            QueueReceived(view.ToOwned());
+            return;
+        }
+        
+        if (dispatch_pool_) {
+            DispatchMessage(view);
+            return;
+        }
+        
+        // Call callbacks if set
+        if (message_view_callback_) {
+            message_view_callback_(view);
         }
+        if (message_callback_) {
+            message_callback_(view.ToOwned());
+        }
+    } else if (response.command() == proto::ResponseType::MessageTraceGossipSub) {
+        if (gossipsub_aggregator_) {
+            gossipsub_aggregator_->Add(response.data());
+        }
+        ForwardTrace(ResponseType::MessageTraceGossipSub, response.data());
+    } else if (response.command() == proto::ResponseType::MessageTraceMumP2P) {
+        if (propagation_tracker_) {
+            propagation_tracker_->Add(response.data());
+        }
+        ForwardTrace(ResponseType::MessageTraceMumP2P, response.data());
+    }
+}
+
+void P2PClient::ForwardTrace(ResponseType type, const std::string& event) {
+    if (!trace_callback_) {
+        return;
+    }
+    
+    // Sampling: every event adds rate credit, each forwarded event costs one
+    double rate = trace_sample_rate_.load(std::memory_order_relaxed);
+    if (rate < 1.0) {
+        trace_sample_credit_ += rate;
+        if (trace_sample_credit_ < 1.0) {
+            return;
+        }
+        trace_sample_credit_ -= 1.0;
+    }
+    
+    trace_callback_(type, event);
+}
+
+void P2PClient::DispatchMessage(const P2PMessageView& view) {
+    std::string_view key = dispatch_order_ == DispatchOrder::PerSource ? view.source_node_id : view.topic;
+    
+    // The view dies with the response, so the job owns a copy
+    dispatch_pending_.fetch_add(1);
+    bool submitted = dispatch_pool_->Submit(std::hash<std::string_view>()(key),
+        [this, message = view.ToOwned()]() {
+            this->InvokeCallbacks(message);
+            this->FinishDispatch();
+        });
+    
+    if (!submitted) {
+        FinishDispatch();
+    }
+}
+
+void P2PClient::InvokeCallbacks(const P2PMessage& message) {
+    if (message_view_callback_) {
+        P2PMessageView view;
+        view.message_id = message.message_id;
+        view.topic = message.topic;
+        view.message = std::string_view(reinterpret_cast<const char*>(message.message.data()), message.message.size());
+        view.source_node_id = message.source_node_id;
+        message_view_callback_(view);
+    }
+    if (message_callback_) {
+        message_callback_(message);
+    }
+}
+
+void P2PClient::FinishDispatch() {
+    if (dispatch_pending_.fetch_sub(1) == 1) {
+        std::lock_guard<std::mutex> lock(dispatch_mutex_);
+        dispatch_idle_.notify_all();
     }
 }
 
@@ -0,0 +1,64 @@
+// Callback dispatch pool implementation
+
+#include "optimum_p2p/dispatch_pool.hpp"
+#include <algorithm>
+
+namespace optimum_p2p {
+
+DispatchPool::DispatchPool(size_t num_threads, size_t queue_depth)
+    : running_(true) {
+    if (num_threads == 0) {
+        num_threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    
+    for (size_t i = 0; i < num_threads; i++) {
+        workers_.push_back(std::make_unique<Worker>(queue_depth));
+    }
+    
+    for (auto& worker : workers_) {
+        Worker* w = worker.get();
+        w->thread = std::thread([w]() {
+            WorkerLoop(*w);
+        });
+    }
+}
+
+DispatchPool::~DispatchPool() {
+    Shutdown();
+}
+
+bool DispatchPool::Submit(size_t key, std::function<void()> job) {
+    if (!running_.load(std::memory_order_relaxed)) {
+        return false;
+    }
+    
+    return workers_[key % workers_.size()]->queue.Push(std::move(job));
+}
+
+void DispatchPool::Shutdown() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+    
+    for (auto& worker : workers_) {
+        worker->queue.Close();
+    }
+    
+    // Workers exit once their queue is drained
+    for (auto& worker : workers_) {
+        if (worker->thread.joinable()) {
+            worker->thread.join();
+        }
+    }
+}
+
+void DispatchPool::WorkerLoop(Worker& worker) {
+    std::function<void()> job;
+    
+    while (worker.queue.Pop(job)) {
+        job();
+        job = nullptr;
+    }
+}
+
+} // namespace optimum_p2p
@@ -0,0 +1,191 @@
+// GossipSub trace aggregator implementation
+
+#include "optimum_p2p/gossipsub_trace.hpp"
+#include "trace.pb.h"
+
+namespace optimum_p2p {
+
+namespace {
+using pubsub::pb::TraceEvent;
+
+static uint64_t HashBytes(const std::string& bytes) {
+    return std::hash<std::string_view>()(bytes);
+}
+} // namespace
+
+GossipSubTraceAggregator::GossipSubTraceAggregator(size_t max_tracked_messages)
+    : max_tracked_messages_(max_tracked_messages ? max_tracked_messages : 1),
+      events_(0), decode_errors_(0), events_by_type_{} {
+}
+
+GossipSubTraceAggregator::~GossipSubTraceAggregator() = default;
+
+bool GossipSubTraceAggregator::Add(const uint8_t* data, size_t size) {
+    return Add(std::string_view(reinterpret_cast<const char*>(data), size));
+}
+
+bool GossipSubTraceAggregator::Add(std::string_view data) {
+    // One message per thread, reused so steady-state decoding does not allocate
+    thread_local TraceEvent event;
+    
+    if (!event.ParseFromArray(data.data(), static_cast<int>(data.size())) || !event.has_type()) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        decode_errors_++;
+        return false;
+    }
+    
+    int64_t timestamp = event.timestamp();
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    events_++;
+    events_by_type_[event.type()]++;
+    
+    switch (event.type()) {
+        case TraceEvent::PUBLISH_MESSAGE: {
+            const auto& publish = event.publishmessage();
+            TopicLocked(publish.topic()).published++;
+            FirstSeenLocked(publish.messageid(), timestamp, true);
+            break;
+        }
+        case TraceEvent::DELIVER_MESSAGE: {
+            const auto& deliver = event.delivermessage();
+            TopicState& topic = TopicLocked(deliver.topic());
+            topic.delivered++;
+            int64_t first_seen = FirstSeenLocked(deliver.messageid(), timestamp, false);
+            topic.delivery_latency.Record(timestamp > first_seen ? uint64_t(timestamp - first_seen) : 0);
+            break;
+        }
+        case TraceEvent::DUPLICATE_MESSAGE: {
+            const auto& duplicate = event.duplicatemessage();
+            TopicLocked(duplicate.topic()).duplicates++;
+            FirstSeenLocked(duplicate.messageid(), timestamp, false);
+            break;
+        }
+        case TraceEvent::REJECT_MESSAGE:
+            TopicLocked(event.rejectmessage().topic()).rejected++;
+            break;
+        case TraceEvent::SEND_RPC:
+            for (const auto& message : event.sendrpc().meta().messages()) {
+                TopicLocked(message.topic()).forwarded++;
+            }
+            break;
+        case TraceEvent::GRAFT: {
+            const auto& graft = event.graft();
+            TopicLocked(graft.topic()).mesh[HashBytes(event.peerid())].insert(HashBytes(graft.peerid()));
+            break;
+        }
+        case TraceEvent::PRUNE: {
+            const auto& prune = event.prune();
+            auto& mesh = TopicLocked(prune.topic()).mesh;
+            auto node = mesh.find(HashBytes(event.peerid()));
+            if (node != mesh.end()) {
+                node->second.erase(HashBytes(prune.peerid()));
+                if (node->second.empty()) {
+                    mesh.erase(node);
+                }
+            }
+            break;
+        }
+        default:
+            break;
+    }
+    
+    return true;
+}
+
+GossipSubTraceAggregator::TopicState& GossipSubTraceAggregator::TopicLocked(const std::string& topic) {
+    auto it = topics_.find(topic);
+    if (it == topics_.end()) {
+        it = topics_.emplace(topic, std::make_unique<TopicState>()).first;
+    }
+    return *it->second;
+}
+
+int64_t GossipSubTraceAggregator::FirstSeenLocked(const std::string& message_id, int64_t timestamp, bool publish) {
+    uint64_t key = HashBytes(message_id);
+    
+    auto it = messages_.find(key);
+    if (it == messages_.end()) {
+        if (messages_.size() >= max_tracked_messages_) {
+            messages_.erase(message_order_.front());
+            message_order_.pop_front();
+        }
+        messages_.emplace(key, MessageInfo{timestamp, publish});
+        message_order_.push_back(key);
+        return timestamp;
+    }
+    
+    // The publish event is the reference once seen; until then the earliest sighting
+    MessageInfo& info = it->second;
+    if (publish && !info.published) {
+        info.first_seen = timestamp;
+        info.published = true;
+    } else if (!info.published && timestamp < info.first_seen) {
+        info.first_seen = timestamp;
+    }
+    
+    return info.first_seen;
+}
+
+void GossipSubTraceAggregator::FillStats(const TopicState& state, GossipSubTopicStats& stats) {
+    stats.published = state.published;
+    stats.delivered = state.delivered;
+    stats.duplicates = state.duplicates;
+    stats.rejected = state.rejected;
+    stats.forwarded = state.forwarded;
+    stats.mesh_nodes = state.mesh.size();
+    stats.mesh_peers = 0;
+    for (const auto& node : state.mesh) {
+        stats.mesh_peers += node.second.size();
+    }
+    stats.delivery_latency = state.delivery_latency.Snapshot();
+}
+
+std::map<std::string, GossipSubTopicStats> GossipSubTraceAggregator::GetTopicStats() const {
+    std::map<std::string, GossipSubTopicStats> result;
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& topic : topics_) {
+        FillStats(*topic.second, result[topic.first]);
+    }
+    
+    return result;
+}
+
+bool GossipSubTraceAggregator::GetTopicStats(const std::string& topic, GossipSubTopicStats& stats) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = topics_.find(topic);
+    if (it == topics_.end()) {
+        return false;
+    }
+    
+    FillStats(*it->second, stats);
+    return true;
+}
+
+GossipSubTraceTotals GossipSubTraceAggregator::GetTotals() const {
+    GossipSubTraceTotals totals;
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    totals.events = events_;
+    totals.decode_errors = decode_errors_;
+    for (size_t i = 0; i < kNumEventTypes; i++) {
+        if (events_by_type_[i]) {
+            totals.events_by_type[TraceEvent::Type_Name(static_cast<TraceEvent::Type>(i))] = events_by_type_[i];
+        }
+    }
+    
+    return totals;
+}
+
+void GossipSubTraceAggregator::Reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    topics_.clear();
+    messages_.clear();
+    message_order_.clear();
+    events_ = 0;
+    decode_errors_ = 0;
+    events_by_type_.fill(0);
+}
+
+} // namespace optimum_p2p
@@ -0,0 +1,128 @@
+// Latency histogram implementation
+
+#include "optimum_p2p/histogram.hpp"
+#include <cmath>
+
+namespace optimum_p2p {
+
+size_t HistogramSnapshot::BucketIndex(uint64_t value) {
+    if (value < kSubBuckets) {
+        return static_cast<size_t>(value);
+    }
+    
+    // Highest set bit picks the power of two, the next kSubBucketBits bits the bucket
+    int magnitude = 63 - __builtin_clzll(value);
+    int shift = magnitude - kSubBucketBits;
+    size_t sub = static_cast<size_t>(value >> shift) - kSubBuckets;
+    return static_cast<size_t>(shift + 1) * kSubBuckets + sub;
+}
+
+uint64_t HistogramSnapshot::BucketLow(size_t index) {
+    if (index < kSubBuckets) {
+        return index;
+    }
+    
+    int shift = static_cast<int>(index / kSubBuckets) - 1;
+    uint64_t sub = index % kSubBuckets;
+    return (kSubBuckets + sub) << shift;
+}
+
+uint64_t HistogramSnapshot::BucketHigh(size_t index) {
+    if (index < kSubBuckets) {
+        return index;
+    }
+    
+    int shift = static_cast<int>(index / kSubBuckets) - 1;
+    return BucketLow(index) + ((uint64_t(1) << shift) - 1);
+}
+
+double HistogramSnapshot::Mean() const {
+    return count_ ? static_cast<double>(sum_) / static_cast<double>(count_) : 0.0;
+}
+
+uint64_t HistogramSnapshot::Percentile(double percentile) const {
+    if (count_ == 0) {
+        return 0;
+    }
+    if (percentile <= 0.0) {
+        return min_;
+    }
+    if (percentile >= 100.0) {
+        return max_;
+    }
+    
+    uint64_t rank = static_cast<uint64_t>(std::ceil(percentile / 100.0 * static_cast<double>(count_)));
+    if (rank == 0) {
+        rank = 1;
+    }
+    
+    uint64_t seen = 0;
+    for (size_t i = 0; i < kNumBuckets; i++) {
+        seen += counts_[i];
+        if (seen >= rank) {
+            uint64_t value = BucketHigh(i);
+            if (value < min_) {
+                return min_;
+            }
+            return value < max_ ? value : max_;
+        }
+    }
+    
+    return max_;
+}
+
+void HistogramSnapshot::Merge(const HistogramSnapshot& other) {
+    for (size_t i = 0; i < kNumBuckets; i++) {
+        counts_[i] += other.counts_[i];
+    }
+    count_ += other.count_;
+    sum_ += other.sum_;
+    if (other.count_ && other.min_ < min_) {
+        min_ = other.min_;
+    }
+    if (other.max_ > max_) {
+        max_ = other.max_;
+    }
+}
+
+LatencyHistogram::LatencyHistogram() {
+    Reset();
+}
+
+void LatencyHistogram::Record(uint64_t value) {
+    counts_[HistogramSnapshot::BucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+    sum_.fetch_add(value, std::memory_order_relaxed);
+    
+    uint64_t current = min_.load(std::memory_order_relaxed);
+    while (value < current && !min_.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+    }
+    current = max_.load(std::memory_order_relaxed);
+    while (value > current && !max_.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+    }
+}
+
+HistogramSnapshot LatencyHistogram::Snapshot() const {
+    HistogramSnapshot snapshot;
+    
+    for (size_t i = 0; i < HistogramSnapshot::kNumBuckets; i++) {
+        uint64_t count = counts_[i].load(std::memory_order_relaxed);
+        snapshot.counts_[i] = count;
+        snapshot.count_ += count;
+    }
+    snapshot.sum_ = sum_.load(std::memory_order_relaxed);
+    snapshot.min_ = min_.load(std::memory_order_relaxed);
+    snapshot.max_ = max_.load(std::memory_order_relaxed);
+    
+    return snapshot;
+}
+
+void LatencyHistogram::Reset() {
+    for (auto& count : counts_) {
+        count.store(0, std::memory_order_relaxed);
+    }
+    sum_.store(0, std::memory_order_relaxed);
+    min_.store(UINT64_MAX, std::memory_order_relaxed);
+    max_.store(0, std::memory_order_relaxed);
+}
+
+} // namespace optimum_p2p
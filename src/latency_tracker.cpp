@@ -0,0 +1,213 @@
+// End-to-end latency tracker implementation
+
+#include "optimum_p2p/latency_tracker.hpp"
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
+
+namespace optimum_p2p {
+
+bool ParsePublishPrefix(std::string_view payload, int64_t& publish_nanos, size_t& size) {
+    if (payload.size() < 5 || payload[0] != '[') {
+        return false;
+    }
+    
+    const char* p = payload.data() + 1;
+    const char* end = payload.data() + payload.size();
+    
+    auto nanos = std::from_chars(p, end, publish_nanos);
+    if (nanos.ec != std::errc() || nanos.ptr == end || *nanos.ptr != ' ') {
+        return false;
+    }
+    
+    auto length = std::from_chars(nanos.ptr + 1, end, size);
+    if (length.ec != std::errc() || length.ptr == end || *length.ptr != ']') {
+        return false;
+    }
+    
+    return true;
+}
+
+// Source of the per-receiver pairs new pairs are merged into past max_pairs
+static constexpr std::string_view kAnySource = "*";
+
+static void PairKey(std::string_view source, std::string_view receiver, std::string& key) {
+    key.assign(source.data(), source.size());
+    key.push_back('\t');
+    key.append(receiver.data(), receiver.size());
+}
+
+LatencyTracker::LatencyTracker(size_t max_pairs)
+    : max_pairs_(max_pairs), missing_prefix_(0), clock_skew_(0), merged_records_(0), summary_stop_(false) {
+}
+
+LatencyTracker::~LatencyTracker() {
+    StopPeriodicSummary();
+}
+
+bool LatencyTracker::Record(std::string_view source, std::string_view receiver,
+                            std::string_view payload, int64_t receive_nanos) {
+    int64_t publish_nanos;
+    size_t size;
+    if (!ParsePublishPrefix(payload, publish_nanos, size)) {
+        missing_prefix_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    
+    RecordLatency(source, receiver, receive_nanos - publish_nanos);
+    return true;
+}
+
+void LatencyTracker::RecordLatency(std::string_view source, std::string_view receiver, int64_t latency_nanos) {
+    if (latency_nanos < 0) {
+        clock_skew_.fetch_add(1, std::memory_order_relaxed);
+        latency_nanos = 0;
+    }
+    
+    PairHistogram(source, receiver).Record(static_cast<uint64_t>(latency_nanos));
+}
+
+LatencyHistogram& LatencyTracker::PairHistogram(std::string_view source, std::string_view receiver) {
+    // Reused per thread so looking up an existing pair does not allocate
+    thread_local std::string key;
+    PairKey(source, receiver, key);
+    
+    {
+        std::shared_lock<std::shared_mutex> lock(pairs_mutex_);
+        auto it = pairs_.find(key);
+        if (it == pairs_.end() && pairs_.size() >= max_pairs_ && source != kAnySource) {
+            source = kAnySource;
+            PairKey(source, receiver, key);
+            merged_records_.fetch_add(1, std::memory_order_relaxed);
+            it = pairs_.find(key);
+        }
+        if (it != pairs_.end()) {
+            return it->second->latency;
+        }
+    }
+    
+    std::unique_lock<std::shared_mutex> lock(pairs_mutex_);
+    
+    // The store may have filled up since the shared lock was released
+    if (source != kAnySource && pairs_.size() >= max_pairs_ && pairs_.find(key) == pairs_.end()) {
+        source = kAnySource;
+        PairKey(source, receiver, key);
+        merged_records_.fetch_add(1, std::memory_order_relaxed);
+    }
+    
+    auto& pair = pairs_[key];
+    if (!pair) {
+        pair = std::make_unique<Pair>();
+        pair->source.assign(source.data(), source.size());
+        pair->receiver.assign(receiver.data(), receiver.size());
+    }
+    return pair->latency;
+}
+
+std::vector<LatencyPairStats> LatencyTracker::GetSnapshot() const {
+    std::vector<LatencyPairStats> result;
+    
+    {
+        std::shared_lock<std::shared_mutex> lock(pairs_mutex_);
+        result.reserve(pairs_.size());
+        for (const auto& entry : pairs_) {
+            result.push_back({entry.second->source, entry.second->receiver, entry.second->latency.Snapshot()});
+        }
+    }
+    
+    std::sort(result.begin(), result.end(), [](const LatencyPairStats& a, const LatencyPairStats& b) {
+        return a.source != b.source ? a.source < b.source : a.receiver < b.receiver;
+    });
+    return result;
+}
+
+bool LatencyTracker::GetPairSnapshot(std::string_view source, std::string_view receiver,
+                                     HistogramSnapshot& snapshot) const {
+    std::string key;
+    PairKey(source, receiver, key);
+    
+    std::shared_lock<std::shared_mutex> lock(pairs_mutex_);
+    auto it = pairs_.find(key);
+    if (it == pairs_.end()) {
+        return false;
+    }
+    
+    snapshot = it->second->latency.Snapshot();
+    return true;
+}
+
+HistogramSnapshot LatencyTracker::GetTotal() const {
+    HistogramSnapshot total;
+    
+    std::shared_lock<std::shared_mutex> lock(pairs_mutex_);
+    for (const auto& entry : pairs_) {
+        total.Merge(entry.second->latency.Snapshot());
+    }
+    
+    return total;
+}
+
+std::string LatencyTracker::Summary() const {
+    auto format = [](const std::string& source, const std::string& receiver, const HistogramSnapshot& h) {
+        char numbers[128];
+        std::snprintf(numbers, sizeof(numbers), "\t%llu\t%.1f\t%.1f\t%.1f\t%.1f\n",
+                      static_cast<unsigned long long>(h.Count()),
+                      h.Percentile(50) / 1000.0, h.Percentile(90) / 1000.0,
+                      h.Percentile(99) / 1000.0, h.Max() / 1000.0);
+        return source + "\t" + receiver + numbers;
+    };
+    
+    std::vector<LatencyPairStats> pairs = GetSnapshot();
+    HistogramSnapshot total;
+    
+    std::string summary = "source\treceiver\tcount\tp50_us\tp90_us\tp99_us\tmax_us\n";
+    for (const auto& pair : pairs) {
+        summary += format(pair.source, pair.receiver, pair.latency);
+        total.Merge(pair.latency);
+    }
+    summary += format("*", "*", total);
+    
+    return summary;
+}
+
+void LatencyTracker::StartPeriodicSummary(std::chrono::milliseconds interval,
+                                          std::function<void(const std::string&)> sink) {
+    StopPeriodicSummary();
+    
+    {
+        std::lock_guard<std::mutex> lock(summary_mutex_);
+        summary_stop_ = false;
+    }
+    summary_thread_ = std::thread([this, interval, sink]() {
+        std::unique_lock<std::mutex> lock(summary_mutex_);
+        while (!summary_cv_.wait_for(lock, interval, [this]() { return summary_stop_; })) {
+            lock.unlock();
+            sink(Summary());
+            lock.lock();
+        }
+    });
+}
+
+void LatencyTracker::StopPeriodicSummary() {
+    {
+        std::lock_guard<std::mutex> lock(summary_mutex_);
+        summary_stop_ = true;
+    }
+    summary_cv_.notify_all();
+    
+    if (summary_thread_.joinable()) {
+        summary_thread_.join();
+    }
+}
+
+void LatencyTracker::Reset() {
+    std::unique_lock<std::shared_mutex> lock(pairs_mutex_);
+    for (auto& entry : pairs_) {
+        entry.second->latency.Reset();
+    }
+    missing_prefix_ = 0;
+    clock_skew_ = 0;
+    merged_records_ = 0;
+}
+
+} // namespace optimum_p2p
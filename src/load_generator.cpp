@@ -0,0 +1,292 @@
+// Open-loop load generator
+
+#include "optimum_p2p/load_generator.hpp"
+#include "optimum_p2p/node_publisher.hpp"
+#include "optimum_p2p/payload_generator.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+
+namespace optimum_p2p {
+
+// Longest a logged line waits in a node thread's buffer
+static constexpr std::chrono::milliseconds kLogHandoffInterval(100);
+
+// LoadSchedule implementation
+
+LoadSchedule::LoadSchedule(const LoadProfile& profile, uint32_t seed)
+    : rate_(std::max(profile.rate, 0.0)),
+      start_rate_(profile.ramp.count() > 0 ? std::max(profile.start_rate, 0.0) : rate_),
+      ramp_(std::chrono::duration<double>(profile.ramp).count()),
+      poisson_(profile.arrivals == ArrivalProcess::Poisson),
+      position_(0),
+      rng_(seed),
+      gap_(1.0) {
+    ramp_messages_ = (start_rate_ + rate_) / 2 * ramp_;
+    
+    // Poisson arrivals are unit-mean exponential steps in message count, which
+    // TimeOf maps onto the (possibly ramping) rate
+    if (poisson_) {
+        position_ = gap_(rng_);
+    }
+}
+
+std::chrono::nanoseconds LoadSchedule::Next() {
+    double seconds = TimeOf(position_);
+    position_ += poisson_ ? gap_(rng_) : 1.0;
+    
+    if (!(seconds * 1e9 < static_cast<double>(std::numeric_limits<int64_t>::max()))) {
+        return std::chrono::nanoseconds::max();
+    }
+    return std::chrono::nanoseconds(std::llround(seconds * 1e9));
+}
+
+double LoadSchedule::MessagesBy(double seconds) const {
+    if (seconds <= 0) {
+        return 0;
+    }
+    if (seconds < ramp_) {
+        double slope = (rate_ - start_rate_) / ramp_;
+        return start_rate_ * seconds + slope * seconds * seconds / 2;
+    }
+    return ramp_messages_ + rate_ * (seconds - ramp_);
+}
+
+double LoadSchedule::TimeOf(double messages) const {
+    if (messages <= 0) {
+        return 0;
+    }
+    
+    if (messages < ramp_messages_) {
+        // Solve start_rate * t + a * t^2 = messages in the form that stays
+        // accurate when a is small or negative
+        double a = (rate_ - start_rate_) / (2 * ramp_);
+        return 2 * messages / (start_rate_ + std::sqrt(start_rate_ * start_rate_ + 4 * a * messages));
+    }
+    
+    if (rate_ <= 0) {
+        return std::numeric_limits<double>::infinity();
+    }
+    return ramp_ + (messages - ramp_messages_) / rate_;
+}
+
+// LoadGenerator implementation
+
+static LoadNodeStats MergeStats(const std::vector<LoadNodeStats>& stats) {
+    LoadNodeStats total;
+    total.address = "*";
+    for (const auto& node_stats : stats) {
+        total.sent += node_stats.sent;
+        total.failed += node_stats.failed;
+        total.target_rate += node_stats.target_rate;
+        total.achieved_rate += node_stats.achieved_rate;
+        total.send_latency.Merge(node_stats.send_latency);
+        total.publish_time.Merge(node_stats.publish_time);
+    }
+    return total;
+}
+
+// Connection, thread and counters of one node
+struct LoadGenerator::Node {
+    explicit Node(const std::string& address) : publisher(address) {}
+    
+    NodePublisher publisher;
+    std::thread thread;
+    std::atomic<uint64_t> sent{0};
+    std::atomic<uint64_t> failed{0};
+    LatencyHistogram send_latency;
+    LatencyHistogram publish_time;
+};
+
+LoadGenerator::LoadGenerator(const std::vector<std::string>& addresses)
+    : addresses_(addresses),
+      payload_generator_(std::make_shared<DefaultPayloadGenerator>()),
+      stop_(false),
+      active_(0) {
+}
+
+LoadGenerator::~LoadGenerator() {
+    Stop();
+    
+    // The writer drains its queue when destroyed
+}
+
+void LoadGenerator::SetOutputFile(const std::string& filename) {
+    if (filename.empty()) {
+        output_writer_.reset();
+        return;
+    }
+    output_writer_ = std::make_unique<AsyncLogWriter>(filename);
+}
+
+void LoadGenerator::SetPayloadGenerator(std::shared_ptr<PayloadGenerator> generator) {
+    payload_generator_ = generator ? std::move(generator) : std::make_shared<DefaultPayloadGenerator>();
+}
+
+bool LoadGenerator::Start(const std::string& topic, const LoadProfile& profile) {
+    if (Running() || (profile.rate <= 0 && (profile.ramp.count() <= 0 || profile.start_rate <= 0))) {
+        return false;
+    }
+    Join();
+    
+    std::vector<std::unique_ptr<Node>> nodes;
+    for (const auto& address : addresses_) {
+        auto node = std::make_unique<Node>(address);
+        // Connect up front so the first scheduled sends are not late
+        node->publisher.Connect();
+        node->publisher.SetLogWriter(output_writer_.get(), kLogHandoffInterval);
+        nodes.push_back(std::move(node));
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        nodes_.swap(nodes);
+        profile_ = profile;
+        stop_ = false;
+        active_ = nodes_.size();
+        started_ = std::chrono::steady_clock::now();
+        finished_ = started_;
+    }
+    
+    for (size_t i = 0; i < nodes_.size(); i++) {
+        Node* node = nodes_[i].get();
+        uint32_t seed = profile.seed + static_cast<uint32_t>(i);
+        node->thread = std::thread([this, node, topic, seed]() {
+            this->NodeLoop(*node, topic, seed);
+        });
+    }
+    return true;
+}
+
+void LoadGenerator::Wait() {
+    Join();
+}
+
+void LoadGenerator::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    stop_cv_.notify_all();
+    
+    Join();
+}
+
+bool LoadGenerator::Running() const {
+    return active_.load() > 0;
+}
+
+void LoadGenerator::Join() {
+    std::lock_guard<std::mutex> lock(join_mutex_);
+    for (auto& node : nodes_) {
+        if (node->thread.joinable()) {
+            node->thread.join();
+        }
+    }
+}
+
+void LoadGenerator::NodeLoop(Node& node, const std::string& topic, uint32_t seed) {
+    LoadSchedule schedule(profile_, seed);
+    auto end = profile_.duration.count() > 0 ? started_ + profile_.duration
+                                             : std::chrono::steady_clock::time_point::max();
+    
+    const std::vector<uint8_t> filler(profile_.payload_size, 'x');
+    std::vector<uint8_t> message; // reused, Generate keeps its capacity
+    int index = 0;
+    
+    while (!stop_) {
+        auto offset = schedule.Next();
+        if (offset == std::chrono::nanoseconds::max() || offset >= end - started_) {
+            break;
+        }
+        
+        // Overdue messages go out immediately; otherwise sleep until due,
+        // waking early if the run is stopped
+        auto due = started_ + std::chrono::duration_cast<std::chrono::steady_clock::duration>(offset);
+        if (std::chrono::steady_clock::now() < due) {
+            std::unique_lock<std::mutex> lock(mutex_);
+            if (stop_cv_.wait_until(lock, due, [this]() { return stop_.load(); })) {
+                break;
+            }
+        }
+        
+        payload_generator_->Generate(filler, index++, 1, message);
+        
+        auto publish_start = std::chrono::steady_clock::now();
+        bool published = node.publisher.Publish(topic, message);
+        auto publish_end = std::chrono::steady_clock::now();
+        
+        if (!published) {
+            node.failed++;
+            continue;
+        }
+        
+        node.sent++;
+        node.send_latency.Record(std::chrono::duration_cast<std::chrono::nanoseconds>(publish_end - due).count());
+        node.publish_time.Record(std::chrono::duration_cast<std::chrono::nanoseconds>(publish_end - publish_start).count());
+        node.publisher.Log(message);
+    }
+    
+    node.publisher.Shutdown();
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (--active_ == 0) {
+        finished_ = std::chrono::steady_clock::now();
+    }
+}
+
+double LoadGenerator::Elapsed() const {
+    auto end = active_ > 0 ? std::chrono::steady_clock::now() : finished_;
+    return std::chrono::duration<double>(end - started_).count();
+}
+
+std::vector<LoadNodeStats> LoadGenerator::GetStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    double elapsed = Elapsed();
+    double target = elapsed > 0 ? LoadSchedule(profile_, profile_.seed).MessagesBy(elapsed) / elapsed : 0;
+    
+    std::vector<LoadNodeStats> stats;
+    for (const auto& node : nodes_) {
+        LoadNodeStats node_stats;
+        node_stats.address = node->publisher.Address();
+        node_stats.sent = node->sent.load();
+        node_stats.failed = node->failed.load();
+        node_stats.target_rate = target;
+        node_stats.achieved_rate = elapsed > 0 ? node_stats.sent / elapsed : 0;
+        node_stats.send_latency = node->send_latency.Snapshot();
+        node_stats.publish_time = node->publish_time.Snapshot();
+        stats.push_back(std::move(node_stats));
+    }
+    return stats;
+}
+
+LoadNodeStats LoadGenerator::GetTotal() const {
+    return MergeStats(GetStats());
+}
+
+std::string LoadGenerator::Summary() const {
+    auto format = [](const LoadNodeStats& s) {
+        char numbers[256];
+        std::snprintf(numbers, sizeof(numbers), "\t%llu\t%llu\t%.1f\t%.1f\t%.1f\t%.1f\t%.1f\t%.1f\t%.1f\n",
+                      static_cast<unsigned long long>(s.sent), static_cast<unsigned long long>(s.failed),
+                      s.target_rate, s.achieved_rate,
+                      s.send_latency.Percentile(50) / 1000.0, s.send_latency.Percentile(99) / 1000.0,
+                      s.send_latency.Max() / 1000.0,
+                      s.publish_time.Percentile(50) / 1000.0, s.publish_time.Percentile(99) / 1000.0);
+        return s.address + numbers;
+    };
+    
+    std::vector<LoadNodeStats> stats = GetStats();
+    
+    std::string summary = "address\tsent\tfailed\ttarget_rate\tachieved_rate\t"
+                          "send_p50_us\tsend_p99_us\tsend_max_us\tpublish_p50_us\tpublish_p99_us\n";
+    for (const auto& node_stats : stats) {
+        summary += format(node_stats);
+    }
+    summary += format(MergeStats(stats));
+    
+    return summary;
+}
+
+} // namespace optimum_p2p
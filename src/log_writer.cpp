@@ -0,0 +1,207 @@
+// Async log writer implementation
+
+#include "optimum_p2p/log_writer.hpp"
+
+namespace optimum_p2p {
+
+AsyncLogWriter::AsyncLogWriter(const std::string& filename)
+    : AsyncLogWriter(filename, Options()) {
+}
+
+AsyncLogWriter::AsyncLogWriter(const std::string& filename, const Options& options)
+    : options_(options),
+      file_(filename, options.append ? std::ios::app : std::ios::trunc),
+      open_(file_.is_open()),
+      head_(&stub_),
+      tail_(&stub_),
+      pending_bytes_(0),
+      closed_(!open_),
+      producers_(0),
+      wake_pending_(false) {
+    if (open_) {
+        batch_.reserve(options_.flush_bytes * 2);
+        thread_ = std::thread([this]() { Run(); });
+    }
+}
+
+AsyncLogWriter::~AsyncLogWriter() {
+    Close();
+}
+
+void AsyncLogWriter::Write(std::string data) {
+    if (data.empty() || !BeginProduce()) {
+        return;
+    }
+    
+    size_t size = data.size();
+    Node* node = new Node();
+    node->data = std::move(data);
+    Push(node);
+    
+    // Wake the writer early only when a full batch is waiting
+    size_t pending = pending_bytes_.fetch_add(size, std::memory_order_relaxed) + size;
+    if (pending >= options_.flush_bytes && pending - size < options_.flush_bytes) {
+        Wake();
+    }
+    EndProduce();
+}
+
+void AsyncLogWriter::Flush() {
+    if (!BeginProduce()) {
+        return;
+    }
+    
+    std::promise<void> flushed;
+    std::future<void> done = flushed.get_future();
+    
+    Node* node = new Node();
+    node->flushed = &flushed;
+    Push(node);
+    
+    Wake();
+    EndProduce();
+    done.wait();
+}
+
+bool AsyncLogWriter::BeginProduce() {
+    // Pairs with Close: either Close sees this producer and waits for its
+    // push, or the producer sees closed_ and backs out
+    producers_.fetch_add(1);
+    if (closed_.load()) {
+        EndProduce();
+        return false;
+    }
+    return true;
+}
+
+void AsyncLogWriter::EndProduce() {
+    producers_.fetch_sub(1);
+}
+
+void AsyncLogWriter::Close() {
+    if (closed_.exchange(true)) {
+        return;
+    }
+    
+    Wake();
+    
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    
+    // Producers that got past the closed_ check finish their push first
+    while (producers_.load() != 0) {
+        std::this_thread::yield();
+    }
+    
+    // Anything pushed while the writer thread was exiting
+    while (Node* node = Pop()) {
+        if (node->flushed) {
+            node->flushed->set_value();
+        } else {
+            batch_.append(node->data);
+        }
+        delete node;
+    }
+    if (open_) {
+        WriteBatch();
+        file_.close();
+    }
+}
+
+void AsyncLogWriter::Wake() {
+    {
+        std::lock_guard<std::mutex> lock(wake_mutex_);
+        wake_pending_ = true;
+    }
+    wake_.notify_one();
+}
+
+void AsyncLogWriter::Push(Node* node) {
+    node->next.store(nullptr, std::memory_order_relaxed);
+    Node* prev = head_.exchange(node, std::memory_order_acq_rel);
+    prev->next.store(node, std::memory_order_release);
+}
+
+AsyncLogWriter::Node* AsyncLogWriter::Pop() {
+    Node* tail = tail_;
+    Node* next = tail->next.load(std::memory_order_acquire);
+    
+    if (tail == &stub_) {
+        if (!next) {
+            return nullptr;
+        }
+        tail_ = next;
+        tail = next;
+        next = next->next.load(std::memory_order_acquire);
+    }
+    
+    if (next) {
+        tail_ = next;
+        return tail;
+    }
+    
+    // tail is the last node unless a producer is between exchange and link
+    if (tail != head_.load(std::memory_order_acquire)) {
+        return nullptr;
+    }
+    
+    Push(&stub_);
+    next = tail->next.load(std::memory_order_acquire);
+    if (next) {
+        tail_ = next;
+        return tail;
+    }
+    return nullptr;
+}
+
+void AsyncLogWriter::Run() {
+    auto last_write = std::chrono::steady_clock::now();
+    
+    while (true) {
+        // Read before draining so everything queued before Close is written
+        bool closing = closed_.load(std::memory_order_acquire);
+        
+        while (Node* node = Pop()) {
+            if (node->flushed) {
+                WriteBatch();
+                last_write = std::chrono::steady_clock::now();
+                node->flushed->set_value();
+            } else {
+                pending_bytes_.fetch_sub(node->data.size(), std::memory_order_relaxed);
+                batch_.append(node->data);
+                if (batch_.size() >= options_.flush_bytes) {
+                    WriteBatch();
+                    last_write = std::chrono::steady_clock::now();
+                }
+            }
+            delete node;
+        }
+        
+        auto now = std::chrono::steady_clock::now();
+        if (closing || now - last_write >= options_.flush_interval) {
+            WriteBatch();
+            last_write = now;
+        }
+        
+        if (closing) {
+            break;
+        }
+        
+        std::unique_lock<std::mutex> lock(wake_mutex_);
+        wake_.wait_for(lock, options_.flush_interval, [this]() { return wake_pending_; });
+        wake_pending_ = false;
+    }
+}
+
+void AsyncLogWriter::WriteBatch() {
+    if (batch_.empty()) {
+        return;
+    }
+    
+    file_.write(batch_.data(), static_cast<std::streamsize>(batch_.size()));
+    file_.flush();
+    batch_.clear();
+}
+
+} // namespace optimum_p2p
@@ -7,86 +7,129 @@
 #include <fstream>
 #include <sstream>
 #include <chrono>
-#include <random>
 #include <iomanip>
+#include <future>
+#include <condition_variable>
 
 namespace optimum_p2p {
 
 // MultiPublishClient implementation
 
+// Persistent connection and thread for one node
+struct MultiPublishClient::Worker {
+    explicit Worker(const std::string& address) : publisher(address) {}
+    
+    NodePublisher publisher; // connects on the worker thread
+    std::thread thread;
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::function<void()> job; // guarded by mutex
+    bool stop = false;         // guarded by mutex
+    std::vector<uint8_t> message; // payload buffer reused across messages
+};
+
 MultiPublishClient::MultiPublishClient(const std::vector<std::string>& addresses)
-    : addresses_(addresses) {
+    : addresses_(addresses),
+      flush_interval_(std::chrono::milliseconds(100)),
+      payload_generator_(std::make_shared<DefaultPayloadGenerator>()) {
 }
 
 MultiPublishClient::~MultiPublishClient() {
-    // Cleanup handled by member destructors
+    for (auto& worker : workers_) {
+        {
+            std::lock_guard<std::mutex> lock(worker->mutex);
+            worker->stop = true;
+        }
+        worker->cv.notify_one();
+    }
+    
+    for (auto& worker : workers_) {
+        if (worker->thread.joinable()) {
+            worker->thread.join();
+        }
+        worker->publisher.Shutdown();
+    }
+    
+    // The writer drains its queue when destroyed
 }
 
 void MultiPublishClient::PublishAll(const std::string& topic, 
                                    const std::vector<uint8_t>& data,
                                    int count,
                                    std::chrono::milliseconds delay) {
-    std::vector<std::thread> threads;
+    std::lock_guard<std::mutex> round_lock(publish_mutex_);
+    StartWorkers();
     
-    for (const auto& address : addresses_) {
-        threads.emplace_back([this, address, topic, data, count, delay]() {
-            this->PublishToNode(address, topic, data, count, delay);
+    // topic and data outlive the round, so workers use them by reference
+    std::vector<std::future<void>> done;
+    for (auto& worker : workers_) {
+        Worker* w = worker.get();
+        auto task = std::make_shared<std::packaged_task<void()>>([this, w, &topic, &data, count, delay]() {
+            this->PublishToNode(*w, topic, data, count, delay);
         });
+        done.push_back(task->get_future());
+        
+        {
+            std::lock_guard<std::mutex> lock(w->mutex);
+            w->job = [task]() { (*task)(); };
+        }
+        w->cv.notify_one();
     }
     
-    // Wait for all threads to complete
-    for (auto& t : threads) {
-        t.join();
+    // Wait for all nodes to complete the round
+    for (auto& f : done) {
+        f.wait();
     }
 }
 
-void MultiPublishClient::PublishToNode(const std::string& address,
+void MultiPublishClient::StartWorkers() {
+    if (!workers_.empty()) {
+        return;
+    }
+    
+    for (const auto& address : addresses_) {
+        workers_.push_back(std::make_unique<Worker>(address));
+    }
+    
+    for (auto& worker : workers_) {
+        Worker* w = worker.get();
+        w->thread = std::thread([this, w]() {
+            this->WorkerLoop(*w);
+        });
+    }
+}
+
+void MultiPublishClient::WorkerLoop(Worker& worker) {
+    while (true) {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(worker.mutex);
+            worker.cv.wait(lock, [&worker]() { return worker.stop || worker.job; });
+            if (!worker.job) {
+                return;
+            }
+            job = std::move(worker.job);
+            worker.job = nullptr;
+        }
+        
+        job();
+    }
+}
+
+void MultiPublishClient::PublishToNode(Worker& worker,
                                       const std::string& topic,
                                       const std::vector<uint8_t>& data,
                                       int count,
                                       std::chrono::milliseconds delay) {
-    P2PClient client(address);
+    NodePublisher& publisher = worker.publisher;
+    publisher.SetLogWriter(output_writer_.get(), flush_interval_);
     
+    std::vector<uint8_t>& message_data = worker.message;
     for (int i = 0; i < count; i++) {
-        std::vector<uint8_t> message_data;
-        
-        if (count == 1) {
-            // Single message: add timestamp prefix like Go implementation
-            auto now = std::chrono::duration_cast<std::chrono::nanoseconds>(
-                std::chrono::system_clock::now().time_since_epoch()).count();
-            std::string prefix = "[" + std::to_string(now) + " " + std::to_string(data.size()) + "] ";
-            message_data.assign(prefix.begin(), prefix.end());
-            message_data.insert(message_data.end(), data.begin(), data.end());
-        } else {
-            // Multiple messages: add random suffix like Go implementation
-            std::random_device rd;
-            std::mt19937 gen(rd());
-            std::uniform_int_distribution<> dis(0, 255);
-            
-            std::vector<uint8_t> random_bytes(4);
-            for (auto& b : random_bytes) {
-                b = static_cast<uint8_t>(dis(gen));
-            }
-            
-            std::string hex_suffix = HeadHex(random_bytes, 4);
-            auto now = std::chrono::duration_cast<std::chrono::nanoseconds>(
-                std::chrono::system_clock::now().time_since_epoch()).count();
-            std::string msg = "[" + std::to_string(now) + " " + std::to_string(hex_suffix.length()) + 
-                            "] " + std::to_string(i + 1) + " - " + hex_suffix + " XXX";
-            message_data.assign(msg.begin(), msg.end());
-        }
+        payload_generator_->Generate(data, i, count, message_data);
         
-        if (client.Publish(topic, message_data)) {
-            // Write to output file if set
-            if (!output_file_.empty()) {
-                std::lock_guard<std::mutex> lock(output_mutex_);
-                std::ofstream file(output_file_, std::ios::app);
-                if (file.is_open()) {
-                    std::string hash = SHA256Hex(message_data);
-                    file << address << "\t" << message_data.size() << "\t" << hash << "\n";
-                    file.flush();
-                }
-            }
+        if (publisher.Publish(topic, message_data)) {
+            publisher.Log(message_data);
         }
         
         if (delay.count() > 0 && i < count - 1) {
@@ -94,17 +137,46 @@ void MultiPublishClient::PublishToNode(const std::string& address,
         }
     }
     
-    client.Shutdown();
+    publisher.FlushLog();
 }
 
 void MultiPublishClient::SetOutputFile(const std::string& filename) {
     output_file_ = filename;
+    
+    if (filename.empty()) {
+        output_writer_.reset();
+        return;
+    }
+    
+    AsyncLogWriter::Options options;
+    options.flush_interval = flush_interval_;
+    output_writer_ = std::make_unique<AsyncLogWriter>(filename, options);
+}
+
+void MultiPublishClient::SetFlushInterval(std::chrono::milliseconds interval) {
+    flush_interval_ = interval;
+    
+    // Reopen so the writer picks up the new interval
+    if (output_writer_) {
+        SetOutputFile(output_file_);
+    }
+}
+
+void MultiPublishClient::Flush() {
+    if (output_writer_) {
+        output_writer_->Flush();
+    }
+}
+
+void MultiPublishClient::SetPayloadGenerator(std::shared_ptr<PayloadGenerator> generator) {
+    payload_generator_ = generator ? std::move(generator) : std::make_shared<DefaultPayloadGenerator>();
 }
 
 // MultiSubscribeClient implementation
 
-MultiSubscribeClient::MultiSubscribeClient(const std::vector<std::string>& addresses)
-    : addresses_(addresses) {
+MultiSubscribeClient::MultiSubscribeClient(const std::vector<std::string>& addresses,
+                                           std::shared_ptr<AsyncEngine> engine)
+    : addresses_(addresses), engine_(std::move(engine)), trace_sample_rate_(1.0) {
 }
 
 MultiSubscribeClient::~MultiSubscribeClient() {
@@ -114,39 +186,88 @@ MultiSubscribeClient::~MultiSubscribeClient() {
             client->Shutdown();
         }
     }
+    
+    // No more callbacks can run; write out what is still queued
+    data_writer_.reset();
+    trace_writer_.reset();
 }
 
 void MultiSubscribeClient::SubscribeAll(const std::string& topic) {
     // Create clients for each address
     clients_.clear();
     for (const auto& address : addresses_) {
-        auto client = std::make_unique<P2PClient>(address);
-        if (client->Subscribe(topic)) {
-            // Set up message callback
-            client->SetMessageCallback([this, address](const P2PMessage& msg) {
-                this->HandleMessage(address, msg);
+        auto client = engine_ ? std::make_unique<P2PClient>(address, engine_)
+                              : std::make_unique<P2PClient>(address);
+        
+        // Set up message callback before subscribing so no message is missed
+        client->SetMessageViewCallback([this, address](const P2PMessageView& msg) {
+            this->HandleMessage(address, msg);
+        });
+        if (trace_callback_ || trace_writer_) {
+            client->SetTraceCallback([this](ResponseType type, std::string_view event) {
+                this->HandleTrace(type, event);
             });
+            client->SetTraceSampleRate(trace_sample_rate_);
+        }
+        client->SetGossipSubAggregator(gossipsub_aggregator_);
+        client->SetPropagationTracker(propagation_tracker_);
+        
+        if (client->Subscribe(topic)) {
             clients_.push_back(std::move(client));
         }
     }
+    
+    if (propagation_tracker_ && propagation_tracker_->ExpectedNodes() == 0) {
+        propagation_tracker_->SetExpectedNodes(clients_.size());
+    }
 }
 
-void MultiSubscribeClient::HandleMessage(const std::string& address, const P2PMessage& msg) {
-    // Call data callback if set
+void MultiSubscribeClient::HandleMessage(const std::string& address, const P2PMessageView& msg) {
+    // Take the receive time before any callback runs
+    if (latency_tracker_) {
+        auto now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        latency_tracker_->Record(msg.source_node_id, address, msg.message, now);
+    }
+    
+    // Call data callback if set (the only path that needs an owned copy)
     if (data_callback_) {
-        data_callback_(address, msg);
-    }
-    
-    // Write to data output file if set
-    if (!data_output_file_.empty()) {
-        std::lock_guard<std::mutex> lock(file_mutex_);
-        std::ofstream file(data_output_file_, std::ios::app);
-        if (file.is_open()) {
-            std::string hash = SHA256Hex(msg.message);
-            file << address << "\t" << msg.source_node_id << "\t" 
-                 << msg.message.size() << "\t" << hash << "\n";
-            file.flush();
+        data_callback_(address, msg.ToOwned());
+    }
+    
+    // Queue a line for the data output file if set
+    if (data_writer_) {
+        // Hash the payload in place in the receive buffer
+        std::array<char, 64> hash;
+        SHA256Hex(reinterpret_cast<const uint8_t*>(msg.message.data()), msg.message.size(), hash);
+        
+        std::string size = std::to_string(msg.message.size());
+        std::string line;
+        line.reserve(address.size() + msg.source_node_id.size() + size.size() + hash.size() + 4);
+        line.append(address).append(1, '\t');
+        line.append(msg.source_node_id).append(1, '\t');
+        line.append(size).append(1, '\t');
+        line.append(hash.data(), hash.size()).append(1, '\n');
+        data_writer_->Write(std::move(line));
+    }
+}
+
+void MultiSubscribeClient::HandleTrace(ResponseType type, std::string_view event) {
+    // Decoding and formatting stay on the receiving thread; the file writer only queues
+    auto sink = [this](const std::string& line) {
+        if (trace_callback_) {
+            trace_callback_(line);
+        }
+        
+        if (trace_writer_) {
+            trace_writer_->Write(line + "\n");
         }
+    };
+    
+    if (type == ResponseType::MessageTraceGossipSub) {
+        HandleGossipSubTrace(event, true, sink);
+    } else {
+        HandleOptimumP2PTrace(event, true, sink);
     }
 }
 
@@ -158,12 +279,39 @@ void MultiSubscribeClient::SetTraceCallback(std::function<void(const std::string
     trace_callback_ = callback;
 }
 
+void MultiSubscribeClient::SetTraceSampleRate(double rate) {
+    trace_sample_rate_ = rate;
+}
+
 void MultiSubscribeClient::SetDataOutputFile(const std::string& filename) {
     data_output_file_ = filename;
+    data_writer_ = filename.empty() ? nullptr : std::make_unique<AsyncLogWriter>(filename);
 }
 
 void MultiSubscribeClient::SetTraceOutputFile(const std::string& filename) {
     trace_output_file_ = filename;
+    trace_writer_ = filename.empty() ? nullptr : std::make_unique<AsyncLogWriter>(filename);
+}
+
+void MultiSubscribeClient::SetGossipSubAggregator(std::shared_ptr<GossipSubTraceAggregator> aggregator) {
+    gossipsub_aggregator_ = std::move(aggregator);
+}
+
+void MultiSubscribeClient::SetPropagationTracker(std::shared_ptr<PropagationTracker> tracker) {
+    propagation_tracker_ = std::move(tracker);
+}
+
+void MultiSubscribeClient::SetLatencyTracker(std::shared_ptr<LatencyTracker> tracker) {
+    latency_tracker_ = std::move(tracker);
+}
+
+void MultiSubscribeClient::Flush() {
+    if (data_writer_) {
+        data_writer_->Flush();
+    }
+    if (trace_writer_) {
+        trace_writer_->Flush();
+    }
 }
 
 } // namespace optimum_p2p
@@ -0,0 +1,314 @@
+// mump2p trace decoding and propagation tracking
+
+#include "optimum_p2p/mump2p_trace.hpp"
+#include "optimum_p2p/utils.hpp"
+#include <algorithm>
+
+namespace optimum_p2p {
+
+namespace {
+
+// Minimal protobuf wire format reader over a borrowed buffer
+class WireReader {
+public:
+    explicit WireReader(std::string_view data)
+        : p_(reinterpret_cast<const uint8_t*>(data.data())), end_(p_ + data.size()) {}
+    
+    bool AtEnd() const {
+        return p_ == end_;
+    }
+    
+    bool ReadVarint(uint64_t& value) {
+        uint64_t result = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (p_ == end_) {
+                return false;
+            }
+            uint8_t byte = *p_++;
+            result |= uint64_t(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) {
+                value = result;
+                return true;
+            }
+        }
+        return false;
+    }
+    
+    bool ReadTag(uint32_t& field, uint32_t& wire_type) {
+        uint64_t tag;
+        if (!ReadVarint(tag)) {
+            return false;
+        }
+        field = static_cast<uint32_t>(tag >> 3);
+        wire_type = static_cast<uint32_t>(tag & 7);
+        return field != 0;
+    }
+    
+    bool ReadBytes(std::string_view& out) {
+        uint64_t size;
+        if (!ReadVarint(size) || size > static_cast<uint64_t>(end_ - p_)) {
+            return false;
+        }
+        out = std::string_view(reinterpret_cast<const char*>(p_), size);
+        p_ += size;
+        return true;
+    }
+    
+    bool Skip(uint32_t wire_type) {
+        uint64_t value;
+        std::string_view bytes;
+        switch (wire_type) {
+            case 0:
+                return ReadVarint(value);
+            case 1:
+                return Advance(8);
+            case 2:
+                return ReadBytes(bytes);
+            case 5:
+                return Advance(4);
+            default:
+                return false; // groups are not used by trace events
+        }
+    }
+
+private:
+    bool Advance(size_t size) {
+        if (size > static_cast<size_t>(end_ - p_)) {
+            return false;
+        }
+        p_ += size;
+        return true;
+    }
+    
+    const uint8_t* p_;
+    const uint8_t* end_;
+};
+
+// Bodies of the publish, reject, duplicate and deliver events; their field 1
+// is the message ID. Other bodies (peer, RPC and mesh events) are skipped.
+constexpr uint32_t kFirstMessageBody = 4;
+constexpr uint32_t kLastMessageBody = 7;
+
+// An absent message ID is not an error
+static bool ReadMessageID(std::string_view body, std::string_view& message_id) {
+    WireReader reader(body);
+    while (!reader.AtEnd()) {
+        uint32_t field, wire_type;
+        if (!reader.ReadTag(field, wire_type)) {
+            return false;
+        }
+        if (field == 1 && wire_type == 2) {
+            return reader.ReadBytes(message_id);
+        }
+        if (!reader.Skip(wire_type)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+bool DecodeMumP2PTrace(std::string_view data, MumP2PTraceEvent& event) {
+    event = MumP2PTraceEvent();
+    bool has_type = false;
+    
+    WireReader reader(data);
+    while (!reader.AtEnd()) {
+        uint32_t field, wire_type;
+        if (!reader.ReadTag(field, wire_type)) {
+            return false;
+        }
+        
+        uint64_t value;
+        std::string_view bytes;
+        if (field == 1 && wire_type == 0) {
+            if (!reader.ReadVarint(value)) {
+                return false;
+            }
+            event.type = static_cast<int32_t>(value);
+            has_type = true;
+        } else if (field == 2 && wire_type == 2) {
+            if (!reader.ReadBytes(event.peer_id)) {
+                return false;
+            }
+        } else if (field == 3 && wire_type == 0) {
+            if (!reader.ReadVarint(value)) {
+                return false;
+            }
+            event.timestamp = static_cast<int64_t>(value);
+        } else if (field >= kFirstMessageBody && field <= kLastMessageBody && wire_type == 2) {
+            if (!reader.ReadBytes(bytes) || !ReadMessageID(bytes, event.message_id)) {
+                return false;
+            }
+        } else if (!reader.Skip(wire_type)) {
+            return false;
+        }
+    }
+    
+    return has_type;
+}
+
+PropagationTracker::PropagationTracker(size_t expected_nodes, size_t max_messages)
+    : expected_nodes_(expected_nodes), max_messages_(max_messages ? max_messages : 1),
+      complete_messages_(0), evicted_incomplete_(0) {
+}
+
+PropagationTracker::~PropagationTracker() = default;
+
+void PropagationTracker::SetExpectedNodes(size_t expected_nodes) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    expected_nodes_ = expected_nodes;
+}
+
+size_t PropagationTracker::ExpectedNodes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return expected_nodes_;
+}
+
+bool PropagationTracker::Add(std::string_view data) {
+    MumP2PTraceEvent event;
+    if (!DecodeMumP2PTrace(data, event)) {
+        return false;
+    }
+    
+    Record(event);
+    return true;
+}
+
+void PropagationTracker::Record(const MumP2PTraceEvent& event) {
+    if (event.message_id.empty()) {
+        return;
+    }
+    
+    bool publish = event.type == MumP2PTraceEvent::kPublishMessage;
+    
+    // Reused per thread so looking up a message ID does not allocate
+    thread_local std::string key;
+    key.assign(event.message_id.data(), event.message_id.size());
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    auto it = messages_.find(key);
+    if (it == messages_.end()) {
+        if (messages_.size() >= max_messages_) {
+            auto oldest = messages_.find(*message_order_.front());
+            if (!oldest->second.complete) {
+                evicted_incomplete_++;
+            }
+            message_order_.pop_front();
+            messages_.erase(oldest);
+        }
+        it = messages_.emplace(key, Entry{event.timestamp, publish, false, {}}).first;
+        message_order_.push_back(&it->first);
+    }
+    
+    Entry& entry = it->second;
+    if (entry.complete) {
+        return;
+    }
+    
+    // The publish event is the origin once seen; until then the earliest sighting
+    if (publish && !entry.published) {
+        entry.origin = event.timestamp;
+        entry.published = true;
+    } else if (!entry.published && event.timestamp < entry.origin) {
+        entry.origin = event.timestamp;
+    }
+    
+    uint32_t node = NodeIndexLocked(event.peer_id);
+    auto seen = std::find_if(entry.first_seen.begin(), entry.first_seen.end(),
+                             [node](const std::pair<uint32_t, int64_t>& s) { return s.first == node; });
+    if (seen == entry.first_seen.end()) {
+        entry.first_seen.emplace_back(node, event.timestamp);
+    } else if (event.timestamp < seen->second) {
+        seen->second = event.timestamp;
+    }
+    
+    if (expected_nodes_ && entry.first_seen.size() >= expected_nodes_) {
+        CompleteLocked(entry);
+    }
+}
+
+uint32_t PropagationTracker::NodeIndexLocked(std::string_view peer_id) {
+    thread_local std::string key;
+    key.assign(peer_id.data(), peer_id.size());
+    
+    auto it = node_index_.find(key);
+    if (it != node_index_.end()) {
+        return it->second;
+    }
+    
+    uint32_t index = static_cast<uint32_t>(nodes_.size());
+    nodes_.push_back(key);
+    node_index_.emplace(key, index);
+    return index;
+}
+
+void PropagationTracker::CompleteLocked(Entry& entry) {
+    int64_t last = entry.origin;
+    for (const auto& seen : entry.first_seen) {
+        int64_t delay = seen.second > entry.origin ? seen.second - entry.origin : 0;
+        time_to_node_.Record(static_cast<uint64_t>(delay));
+        last = std::max(last, seen.second);
+    }
+    time_to_all_nodes_.Record(static_cast<uint64_t>(last - entry.origin));
+    
+    // Keep the entry, sightings included, until evicted: late events for the
+    // message are recognized and GetTimeline still shows its propagation
+    entry.complete = true;
+    complete_messages_++;
+}
+
+bool PropagationTracker::GetTimeline(std::string_view message_id, MessageTimeline& timeline) const {
+    std::string key(message_id);
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = messages_.find(key);
+    if (it == messages_.end()) {
+        return false;
+    }
+    
+    const Entry& entry = it->second;
+    timeline.origin = entry.origin;
+    timeline.published = entry.published;
+    timeline.complete = entry.complete;
+    timeline.first_seen.clear();
+    for (const auto& seen : entry.first_seen) {
+        const std::string& peer = nodes_[seen.first];
+        timeline.first_seen.emplace_back(
+            Base58Encode(reinterpret_cast<const uint8_t*>(peer.data()), peer.size()), seen.second);
+    }
+    std::sort(timeline.first_seen.begin(), timeline.first_seen.end(),
+              [](const auto& a, const auto& b) { return a.second < b.second; });
+    
+    return true;
+}
+
+PropagationStats PropagationTracker::GetStats() const {
+    PropagationStats stats;
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats.expected_nodes = expected_nodes_;
+    stats.tracked_messages = messages_.size();
+    stats.complete_messages = complete_messages_;
+    stats.evicted_incomplete = evicted_incomplete_;
+    stats.time_to_all_nodes = time_to_all_nodes_.Snapshot();
+    stats.time_to_node = time_to_node_.Snapshot();
+    
+    return stats;
+}
+
+void PropagationTracker::Reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    messages_.clear();
+    message_order_.clear();
+    node_index_.clear();
+    nodes_.clear();
+    complete_messages_ = 0;
+    evicted_incomplete_ = 0;
+    time_to_all_nodes_.Reset();
+    time_to_node_.Reset();
+}
+
+} // namespace optimum_p2p
@@ -0,0 +1,86 @@
+// Single-node publisher shared by MultiPublishClient and LoadGenerator
+
+#include "optimum_p2p/node_publisher.hpp"
+#include "optimum_p2p/utils.hpp"
+#include <array>
+
+namespace optimum_p2p {
+
+// Log lines are handed to the writer in chunks of this size
+static constexpr size_t kLogChunkBytes = 16 * 1024;
+
+NodePublisher::NodePublisher(const std::string& address)
+    : address_(address),
+      log_writer_(nullptr),
+      handoff_interval_(std::chrono::milliseconds(100)),
+      last_handoff_(std::chrono::steady_clock::now()) {
+}
+
+NodePublisher::~NodePublisher() {
+    Shutdown();
+}
+
+void NodePublisher::Connect() {
+    if (!client_) {
+        client_ = std::make_unique<P2PClient>(address_);
+    }
+}
+
+bool NodePublisher::Publish(const std::string& topic, const std::vector<uint8_t>& message) {
+    Connect();
+    
+    if (client_->Publish(topic, message)) {
+        return true;
+    }
+    
+    // The stream is gone (node restarted, network error): reconnect and retry once
+    client_->Shutdown();
+    client_ = std::make_unique<P2PClient>(address_);
+    return client_->Publish(topic, message);
+}
+
+void NodePublisher::SetLogWriter(AsyncLogWriter* writer, std::chrono::milliseconds handoff_interval) {
+    if (writer != log_writer_) {
+        FlushLog();
+    }
+    log_writer_ = writer;
+    handoff_interval_ = handoff_interval;
+}
+
+void NodePublisher::Log(const std::vector<uint8_t>& message) {
+    if (!log_writer_) {
+        return;
+    }
+    
+    std::array<char, 64> hash;
+    SHA256Hex(message.data(), message.size(), hash);
+    
+    log_buffer_.append(address_).append(1, '\t');
+    log_buffer_.append(std::to_string(message.size())).append(1, '\t');
+    log_buffer_.append(hash.data(), hash.size()).append(1, '\n');
+    
+    auto now = std::chrono::steady_clock::now();
+    if (log_buffer_.size() >= kLogChunkBytes || now - last_handoff_ >= handoff_interval_) {
+        log_writer_->Write(std::move(log_buffer_));
+        log_buffer_.clear();
+        last_handoff_ = now;
+    }
+}
+
+void NodePublisher::FlushLog() {
+    if (log_writer_ && !log_buffer_.empty()) {
+        log_writer_->Write(std::move(log_buffer_));
+    }
+    log_buffer_.clear();
+    last_handoff_ = std::chrono::steady_clock::now();
+}
+
+void NodePublisher::Shutdown() {
+    FlushLog();
+    if (client_) {
+        client_->Shutdown();
+        client_.reset();
+    }
+}
+
+} // namespace optimum_p2p
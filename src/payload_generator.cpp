@@ -0,0 +1,124 @@
+// Payload generators and fast random numbers for publishing
+
+#include "optimum_p2p/payload_generator.hpp"
+#include "optimum_p2p/utils.hpp"
+#include <charconv>
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <random>
+#include <thread>
+
+namespace optimum_p2p {
+
+namespace {
+
+int64_t NowNanos() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+// FastRandom implementation
+
+FastRandom::FastRandom(uint64_t seed) {
+    for (auto& word : state_) {
+        word = SplitMix64(seed);
+    }
+}
+
+uint64_t FastRandom::SplitMix64(uint64_t& state) {
+    uint64_t z = (state += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+void FastRandom::Fill(uint8_t* out, size_t size) {
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        uint64_t value = Next();
+        std::memcpy(out + i, &value, 8);
+    }
+    if (i < size) {
+        uint64_t value = Next();
+        std::memcpy(out + i, &value, size - i);
+    }
+}
+
+FastRandom& FastRandom::ThreadLocal() {
+    // random_device is only read once per thread; the thread ID keeps threads
+    // apart even if it returns the same value
+    thread_local FastRandom random(
+        (static_cast<uint64_t>(std::random_device()()) << 32) ^
+        std::hash<std::thread::id>()(std::this_thread::get_id()));
+    return random;
+}
+
+size_t FormatPublishPrefix(int64_t publish_nanos, size_t size, char* out) {
+    char* end = out + kMaxPublishPrefixSize;
+    char* p = out;
+    *p++ = '[';
+    p = std::to_chars(p, end, publish_nanos).ptr;
+    *p++ = ' ';
+    p = std::to_chars(p, end, size).ptr;
+    *p++ = ']';
+    *p++ = ' ';
+    return p - out;
+}
+
+// DefaultPayloadGenerator implementation
+
+void DefaultPayloadGenerator::Generate(const std::vector<uint8_t>& data, int index, int count,
+                                       std::vector<uint8_t>& out) {
+    char prefix[kMaxPublishPrefixSize];
+    
+    if (count == 1) {
+        size_t prefix_size = FormatPublishPrefix(NowNanos(), data.size(), prefix);
+        out.resize(prefix_size + data.size());
+        std::memcpy(out.data(), prefix, prefix_size);
+        if (!data.empty()) {
+            std::memcpy(out.data() + prefix_size, data.data(), data.size());
+        }
+        return;
+    }
+    
+    // "[<nanos> 8] <index + 1> - <hex> XXX"
+    uint8_t random_bytes[4];
+    FastRandom::ThreadLocal().Fill(random_bytes, sizeof(random_bytes));
+    
+    size_t prefix_size = FormatPublishPrefix(NowNanos(), 2 * sizeof(random_bytes), prefix);
+    char number[16];
+    size_t number_size = std::to_chars(number, number + sizeof(number), index + 1).ptr - number;
+    
+    out.resize(prefix_size + number_size + 3 + 2 * sizeof(random_bytes) + 4);
+    char* p = reinterpret_cast<char*>(out.data());
+    std::memcpy(p, prefix, prefix_size);
+    p += prefix_size;
+    std::memcpy(p, number, number_size);
+    p += number_size;
+    std::memcpy(p, " - ", 3);
+    p += 3;
+    HexEncode(random_bytes, sizeof(random_bytes), p);
+    p += 2 * sizeof(random_bytes);
+    std::memcpy(p, " XXX", 4);
+}
+
+// RandomPayloadGenerator implementation
+
+RandomPayloadGenerator::RandomPayloadGenerator(size_t size)
+    : size_(size) {
+}
+
+void RandomPayloadGenerator::Generate(const std::vector<uint8_t>& /*data*/, int /*index*/, int /*count*/,
+                                      std::vector<uint8_t>& out) {
+    char prefix[kMaxPublishPrefixSize];
+    size_t prefix_size = FormatPublishPrefix(NowNanos(), size_, prefix);
+    
+    out.resize(prefix_size + size_);
+    std::memcpy(out.data(), prefix, prefix_size);
+    FastRandom::ThreadLocal().Fill(out.data() + prefix_size, size_);
+}
+
+} // namespace optimum_p2p
@@ -11,9 +11,19 @@
 #include <grpcpp/create_channel.h>
 #include <grpcpp/security/credentials.h>
 #include <climits>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <vector>
 
 namespace optimum_p2p {
 
+// The reused receive message is rebuilt after holding a payload larger than this
+static constexpr size_t kMaxRetainedMessageBytes = 1024 * 1024;
+
+// Default limit of outstanding PublishAsync requests
+static constexpr size_t kDefaultMaxInFlight = 64;
+
 // CURL write callback for response data
 static size_t WriteCallback(void* contents, size_t size, size_t nmemb, std::string* data) {
     size_t total_size = size * nmemb;
@@ -21,10 +31,278 @@ static size_t WriteCallback(void* contents, size_t size, size_t nmemb, std::stri
     return total_size;
 }
 
+// Easy handles are kept between REST calls, one per concurrently calling
+// thread. Each keeps its own kept-alive connection in its connection cache,
+// so requests do not reconnect; DNS and TLS sessions are shared through one
+// CURLSH. Connections themselves are not shared: libcurl does not support
+// that between handles running concurrently in different threads.
+struct ProxyClient::RestPool {
+    CURLSH* share = nullptr;
+    std::mutex share_locks[CURL_LOCK_DATA_LAST];
+    curl_slist* headers = nullptr;
+    
+    std::mutex mutex;
+    std::vector<CURL*> idle; // guarded by mutex
+    
+    RestPool() {
+        share = curl_share_init();
+        if (share) {
+            curl_share_setopt(share, CURLSHOPT_LOCKFUNC, Lock);
+            curl_share_setopt(share, CURLSHOPT_UNLOCKFUNC, Unlock);
+            curl_share_setopt(share, CURLSHOPT_USERDATA, this);
+            curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+            curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+        }
+        
+        headers = curl_slist_append(headers, "Content-Type: application/json");
+        // Skip the 100-continue round trip libcurl adds before larger bodies
+        headers = curl_slist_append(headers, "Expect:");
+    }
+    
+    ~RestPool() {
+        for (CURL* handle : idle) {
+            curl_easy_cleanup(handle);
+        }
+        if (share) {
+            curl_share_cleanup(share);
+        }
+        curl_slist_free_all(headers);
+    }
+    
+    CURL* Acquire() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!idle.empty()) {
+                CURL* handle = idle.back();
+                idle.pop_back();
+                return handle;
+            }
+        }
+        
+        CURL* handle = curl_easy_init();
+        if (!handle) {
+            return nullptr;
+        }
+        curl_easy_setopt(handle, CURLOPT_HTTPHEADER, headers);
+        curl_easy_setopt(handle, CURLOPT_WRITEFUNCTION, WriteCallback);
+        curl_easy_setopt(handle, CURLOPT_TCP_KEEPALIVE, 1L);
+        curl_easy_setopt(handle, CURLOPT_NOSIGNAL, 1L);
+        if (share) {
+            curl_easy_setopt(handle, CURLOPT_SHARE, share);
+        }
+        return handle;
+    }
+    
+    void Release(CURL* handle) {
+        std::lock_guard<std::mutex> lock(mutex);
+        idle.push_back(handle);
+    }
+    
+    static void Lock(CURL*, curl_lock_data data, curl_lock_access, void* userptr) {
+        static_cast<RestPool*>(userptr)->share_locks[data].lock();
+    }
+    
+    static void Unlock(CURL*, curl_lock_data data, void* userptr) {
+        static_cast<RestPool*>(userptr)->share_locks[data].unlock();
+    }
+};
+
+// Runs PublishAsync requests on one thread with curl's multi interface.
+// Submit blocks while max_in_flight requests are outstanding, and curl opens
+// and keeps at most max_in_flight connections; the destructor lets
+// outstanding requests complete.
+struct ProxyClient::AsyncRest {
+    struct Request {
+        std::string body;
+        std::string response;
+        std::function<void(bool)> done;
+    };
+    
+    CURLM* multi;
+    std::string endpoint;
+    curl_slist* headers; // owned by the client's RestPool
+    bool multiplex;      // https: wait for HTTP/2 to multiplex instead of connecting
+    
+    std::mutex mutex;
+    std::condition_variable window_cv;
+    std::deque<std::unique_ptr<Request>> pending; // guarded by mutex
+    size_t outstanding = 0;                       // submitted, not completed; guarded by mutex
+    size_t max_in_flight;                         // guarded by mutex
+    bool stop = false;                            // guarded by mutex
+    
+    std::vector<CURL*> idle;     // used by the loop thread only
+    size_t connection_limit = 0; // applied to multi; loop thread only
+    std::thread thread;
+    
+    AsyncRest(std::string endpoint_url, curl_slist* shared_headers, size_t max)
+        : multi(curl_multi_init()),
+          endpoint(std::move(endpoint_url)),
+          headers(shared_headers),
+          multiplex(endpoint.compare(0, 8, "https://") == 0),
+          max_in_flight(max) {
+        curl_multi_setopt(multi, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+        LimitConnections(max);
+        thread = std::thread([this]() {
+            this->Run();
+        });
+    }
+    
+    ~AsyncRest() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stop = true;
+        }
+        curl_multi_wakeup(multi);
+        thread.join();
+        
+        for (CURL* handle : idle) {
+            curl_easy_cleanup(handle);
+        }
+        curl_multi_cleanup(multi);
+    }
+    
+    void Submit(std::string body, std::function<void(bool)> done) {
+        auto request = std::make_unique<Request>();
+        request->body = std::move(body);
+        request->done = std::move(done);
+        
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            window_cv.wait(lock, [this]() { return outstanding < max_in_flight; });
+            outstanding++;
+            pending.push_back(std::move(request));
+        }
+        curl_multi_wakeup(multi);
+    }
+    
+    void SetMaxInFlight(size_t max) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            max_in_flight = max;
+        }
+        window_cv.notify_all();
+        curl_multi_wakeup(multi); // the loop thread applies the new limit
+    }
+    
+    // Without a bound each request waiting for a connection opens another one,
+    // and connections beyond the cache size are closed after every request
+    void LimitConnections(size_t max) {
+        connection_limit = max;
+        curl_multi_setopt(multi, CURLMOPT_MAX_TOTAL_CONNECTIONS, static_cast<long>(max));
+        curl_multi_setopt(multi, CURLMOPT_MAXCONNECTS, static_cast<long>(max));
+    }
+    
+    void Wait() {
+        std::unique_lock<std::mutex> lock(mutex);
+        window_cv.wait(lock, [this]() { return outstanding == 0; });
+    }
+    
+    CURL* AcquireHandle() {
+        if (!idle.empty()) {
+            CURL* handle = idle.back();
+            idle.pop_back();
+            return handle;
+        }
+        
+        CURL* handle = curl_easy_init();
+        if (!handle) {
+            return nullptr;
+        }
+        curl_easy_setopt(handle, CURLOPT_URL, endpoint.c_str());
+        curl_easy_setopt(handle, CURLOPT_HTTPHEADER, headers);
+        curl_easy_setopt(handle, CURLOPT_WRITEFUNCTION, WriteCallback);
+        curl_easy_setopt(handle, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_2TLS);
+        curl_easy_setopt(handle, CURLOPT_PIPEWAIT, multiplex ? 1L : 0L);
+        curl_easy_setopt(handle, CURLOPT_TCP_KEEPALIVE, 1L);
+        curl_easy_setopt(handle, CURLOPT_NOSIGNAL, 1L);
+        return handle;
+    }
+    
+    void Complete(std::unique_ptr<Request> request, bool ok) {
+        request->done(ok);
+        
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            outstanding--;
+        }
+        window_cv.notify_all();
+    }
+    
+    void Run() {
+        size_t active = 0;
+        while (true) {
+            std::deque<std::unique_ptr<Request>> batch;
+            size_t limit;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (stop && pending.empty() && active == 0) {
+                    break;
+                }
+                batch.swap(pending);
+                limit = max_in_flight;
+            }
+            
+            if (limit != connection_limit) {
+                LimitConnections(limit);
+            }
+            
+            for (auto& request : batch) {
+                CURL* handle = AcquireHandle();
+                if (!handle) {
+                    Complete(std::move(request), false);
+                    continue;
+                }
+                curl_easy_setopt(handle, CURLOPT_POSTFIELDS, request->body.c_str());
+                curl_easy_setopt(handle, CURLOPT_POSTFIELDSIZE_LARGE, static_cast<curl_off_t>(request->body.size()));
+                curl_easy_setopt(handle, CURLOPT_WRITEDATA, &request->response);
+                curl_easy_setopt(handle, CURLOPT_PRIVATE, request.get());
+                if (curl_multi_add_handle(multi, handle) != CURLM_OK) {
+                    curl_easy_setopt(handle, CURLOPT_WRITEDATA, nullptr);
+                    idle.push_back(handle);
+                    Complete(std::move(request), false);
+                    continue;
+                }
+                request.release(); // owned through CURLOPT_PRIVATE until done
+                active++;
+            }
+            
+            int running = 0;
+            curl_multi_perform(multi, &running);
+            
+            int queued = 0;
+            while (CURLMsg* message = curl_multi_info_read(multi, &queued)) {
+                if (message->msg != CURLMSG_DONE) {
+                    continue;
+                }
+                
+                CURL* handle = message->easy_handle;
+                CURLcode result = message->data.result;
+                char* request_ptr = nullptr;
+                long response_code = 0;
+                curl_easy_getinfo(handle, CURLINFO_PRIVATE, &request_ptr);
+                curl_easy_getinfo(handle, CURLINFO_RESPONSE_CODE, &response_code);
+                
+                curl_multi_remove_handle(multi, handle);
+                curl_easy_setopt(handle, CURLOPT_WRITEDATA, nullptr);
+                idle.push_back(handle);
+                active--;
+                
+                std::unique_ptr<Request> request(reinterpret_cast<Request*>(request_ptr));
+                Complete(std::move(request), result == CURLE_OK && response_code >= 200 && response_code < 300);
+            }
+            
+            // Woken early by Submit, SetMaxInFlight and the destructor
+            curl_multi_poll(multi, nullptr, 0, 100, nullptr);
+        }
+    }
+};
+
 ProxyClient::ProxyClient(const std::string& rest_url, const std::string& grpc_address)
-    : rest_url_(rest_url), grpc_address_(grpc_address) {
+    : rest_url_(rest_url), grpc_address_(grpc_address), receive_message_(nullptr),
+      max_in_flight_(kDefaultMaxInFlight) {
     // Initialize CURL (thread-safe in modern versions)
     curl_global_init(CURL_GLOBAL_DEFAULT);
+    rest_ = std::make_unique<RestPool>();
 }
 
 ProxyClient::~ProxyClient() {
@@ -40,6 +318,10 @@ ProxyClient::~ProxyClient() {
     stub_.reset();
     channel_.reset();
     
+    // Handles must go before the global cleanup; async_ first, it uses
+    // rest_'s headers and completes outstanding publishes
+    async_.reset();
+    rest_.reset();
     curl_global_cleanup();
 }
 
@@ -60,15 +342,66 @@ bool ProxyClient::Subscribe(const std::string& client_id,
 bool ProxyClient::Publish(const std::string& client_id,
                         const std::string& topic,
                         const std::string& message) {
+    std::string json_str = PublishBody(client_id, topic, message);
+    std::string endpoint = rest_url_ + "/api/v1/publish";
+    
+    return PostJSON(endpoint, json_str);
+}
+
+std::future<bool> ProxyClient::PublishAsync(const std::string& client_id,
+                                            const std::string& topic,
+                                            const std::string& message) {
+    auto promise = std::make_shared<std::promise<bool>>();
+    std::future<bool> result = promise->get_future();
+    PublishAsync(client_id, topic, message, [promise](bool ok) {
+        promise->set_value(ok);
+    });
+    return result;
+}
+
+void ProxyClient::PublishAsync(const std::string& client_id,
+                               const std::string& topic,
+                               const std::string& message,
+                               std::function<void(bool)> done) {
+    AsyncRest* async;
+    {
+        std::lock_guard<std::mutex> lock(async_mutex_);
+        if (!async_) {
+            async_ = std::make_unique<AsyncRest>(rest_url_ + "/api/v1/publish", rest_->headers, max_in_flight_);
+        }
+        async = async_.get();
+    }
+    
+    async->Submit(PublishBody(client_id, topic, message), std::move(done));
+}
+
+void ProxyClient::SetMaxInFlight(size_t max_in_flight) {
+    std::lock_guard<std::mutex> lock(async_mutex_);
+    max_in_flight_ = max_in_flight > 0 ? max_in_flight : 1;
+    if (async_) {
+        async_->SetMaxInFlight(max_in_flight_);
+    }
+}
+
+void ProxyClient::WaitAsync() {
+    AsyncRest* async;
+    {
+        std::lock_guard<std::mutex> lock(async_mutex_);
+        async = async_.get();
+    }
+    if (async) {
+        async->Wait();
+    }
+}
+
+std::string ProxyClient::PublishBody(const std::string& client_id,
+                                     const std::string& topic,
+                                     const std::string& message) {
     nlohmann::json payload;
     payload["client_id"] = client_id;
     payload["topic"] = topic;
     payload["message"] = message;
-    
-    std::string json_str = payload.dump();
-    std::string endpoint = rest_url_ + "/api/v1/publish";
-    
-    return PostJSON(endpoint, json_str);
+    return payload.dump();
 }
 
 bool ProxyClient::ConnectStream(const std::string& client_id) {
@@ -114,7 +447,15 @@ bool ProxyClient::ReceiveMessage(std::string& topic, std::string& message, int t
         return false;
     }
     
-    proto::ProxyMessage msg;
+    // Reuse one arena-allocated message across reads; drop it after an oversized payload
+    if (receive_message_ && receive_message_->message().capacity() > kMaxRetainedMessageBytes) {
+        receive_message_ = nullptr;
+        arena_.Reset();
+    }
+    if (!receive_message_) {
+        receive_message_ = google::protobuf::Arena::CreateMessage<proto::ProxyMessage>(&arena_);
+    }
+    proto::ProxyMessage& msg = *receive_message_;
     
     // For timeout, we'd need async reading, but for simplicity, just try to read
     // In a real implementation, you'd use async API or a separate thread
@@ -148,29 +489,26 @@ std::string ProxyClient::GenerateClientID() {
 }
 
 bool ProxyClient::PostJSON(const std::string& endpoint, const std::string& json_data) {
-    CURL* curl = curl_easy_init();
+    CURL* curl = rest_->Acquire();
     if (!curl) {
         return false;
     }
     
     std::string response_data;
     
-    struct curl_slist* headers = nullptr;
-    headers = curl_slist_append(headers, "Content-Type: application/json");
-    
     curl_easy_setopt(curl, CURLOPT_URL, endpoint.c_str());
     curl_easy_setopt(curl, CURLOPT_POSTFIELDS, json_data.c_str());
-    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
-    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);
+    curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE_LARGE, static_cast<curl_off_t>(json_data.size()));
     curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response_data);
     
     CURLcode res = curl_easy_perform(curl);
     
-    long response_code;
+    long response_code = 0;
     curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &response_code);
     
-    curl_slist_free_all(headers);
-    curl_easy_cleanup(curl);
+    // Nothing points at this call's buffers once the handle is back in the pool
+    curl_easy_setopt(curl, CURLOPT_WRITEDATA, nullptr);
+    rest_->Release(curl);
     
     return (res == CURLE_OK && response_code >= 200 && response_code < 300);
 }
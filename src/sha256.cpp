@@ -0,0 +1,68 @@
+// SHA-256 hasher implementation (OpenSSL EVP)
+
+#include "optimum_p2p/sha256.hpp"
+#include "optimum_p2p/utils.hpp"
+#include <openssl/evp.h>
+
+namespace optimum_p2p {
+
+namespace {
+
+// Fetch the digest implementation once; EVP_sha256() would repeat the
+// provider lookup on every init under OpenSSL 3
+const EVP_MD* Sha256Digest() {
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+    static EVP_MD* md = EVP_MD_fetch(nullptr, "SHA256", nullptr);
+    if (md) {
+        return md;
+    }
+#endif
+    return EVP_sha256();
+}
+
+} // namespace
+
+Sha256Hasher::Sha256Hasher()
+    : ctx_(EVP_MD_CTX_new()), ok_(false) {
+    Reset();
+}
+
+Sha256Hasher::~Sha256Hasher() {
+    EVP_MD_CTX_free(ctx_);
+}
+
+void Sha256Hasher::Reset() {
+    ok_ = ctx_ && EVP_DigestInit_ex(ctx_, Sha256Digest(), nullptr) == 1;
+}
+
+void Sha256Hasher::Update(const void* data, size_t size) {
+    if (ok_ && size > 0) {
+        ok_ = EVP_DigestUpdate(ctx_, data, size) == 1;
+    }
+}
+
+bool Sha256Hasher::Final(Digest& digest) {
+    unsigned int len = 0;
+    bool ok = ok_ && EVP_DigestFinal_ex(ctx_, digest.data(), &len) == 1 && len == kDigestSize;
+    Reset();
+    return ok;
+}
+
+bool Sha256Hasher::FinalHex(std::array<char, 2 * kDigestSize>& hex) {
+    Digest digest;
+    if (!Final(digest)) {
+        return false;
+    }
+    HexEncode(digest.data(), digest.size(), hex.data());
+    return true;
+}
+
+std::string Sha256Hasher::FinalHex() {
+    std::array<char, 2 * kDigestSize> hex;
+    if (!FinalHex(hex)) {
+        return "";
+    }
+    return std::string(hex.data(), hex.size());
+}
+
+} // namespace optimum_p2p
@@ -1,36 +1,16 @@
 // Utility functions implementation
 
 #include "optimum_p2p/utils.hpp"
+#include "optimum_p2p/base64.hpp"
+#include "optimum_p2p/sha256.hpp"
+#include "optimum_p2p/mump2p_trace.hpp"
+#include "trace.pb.h"
 #include <fstream>
-#include <sstream>
+#include <array>
 #include <algorithm>
-#include <iomanip>
-#include <openssl/sha.h>
-#include <nlohmann/json.hpp>
 #include <stdexcept>
 #include <cctype>
-
-// Base64 decoding helper
-std::vector<uint8_t> base64_decode(const std::string& encoded) {
-    const std::string chars = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
-    std::vector<uint8_t> result;
-    int val = 0, valb = -8;
-    
-    for (unsigned char c : encoded) {
-        if (c == '=') break;
-        if (chars.find(c) == std::string::npos) continue;
-        
-        val = (val << 6) + chars.find(c);
-        valb += 6;
-        
-        if (valb >= 0) {
-            result.push_back((val >> valb) & 0xFF);
-            valb -= 8;
-        }
-    }
-    
-    return result;
-}
+#include <cstring>
 
 namespace optimum_p2p {
 
@@ -59,122 +39,609 @@ std::vector<std::string> ReadIPsFromFile(const std::string& filename) {
     return ips;
 }
 
-std::string SHA256Hex(const std::vector<uint8_t>& data) {
-    if (data.empty()) {
-        // Return SHA256 of empty string: e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855
-        unsigned char hash[SHA256_DIGEST_LENGTH];
-        SHA256_CTX sha256;
-        SHA256_Init(&sha256);
-        SHA256_Final(hash, &sha256);
+namespace {
+
+// Two lowercase hex digits for every byte value
+constexpr std::array<char, 512> MakeHexTable() {
+    const char* digits = "0123456789abcdef";
+    std::array<char, 512> table{};
+    for (size_t i = 0; i < 256; i++) {
+        table[2 * i] = digits[i >> 4];
+        table[2 * i + 1] = digits[i & 0x0F];
+    }
+    return table;
+}
+
+constexpr std::array<char, 512> kHexTable = MakeHexTable();
+
+} // namespace
+
+void HexEncode(const uint8_t* data, size_t size, char* out) {
+    for (size_t i = 0; i < size; i++) {
+        std::memcpy(out + 2 * i, &kHexTable[2 * data[i]], 2);
+    }
+}
+
+std::string Base58Encode(const uint8_t* data, size_t size) {
+    static const char* kAlphabet = "123456789ABCDEFGHJKLMNPQRSTUVWXYZabcdefghijkmnopqrstuvwxyz";
+    constexpr uint64_t kLimbBase = 656356768; // 58^5
+    
+    // Leading zero bytes map to leading '1's
+    size_t zeros = 0;
+    while (zeros < size && data[zeros] == 0) {
+        zeros++;
+    }
+    
+    // Long division into base-58^5 limbs (least significant first), taking
+    // up to three input bytes per pass
+    std::vector<uint32_t> limbs;
+    limbs.reserve((size - zeros) * 138 / 500 + 1);
+    for (size_t i = zeros; i < size;) {
+        size_t chunk = std::min<size_t>(3, size - i);
+        uint64_t carry = 0;
+        for (size_t k = 0; k < chunk; k++) {
+            carry = (carry << 8) | data[i++];
+        }
+        uint64_t multiplier = uint64_t(1) << (8 * chunk);
+        
+        for (auto& limb : limbs) {
+            carry += limb * multiplier;
+            limb = static_cast<uint32_t>(carry % kLimbBase);
+            carry /= kLimbBase;
+        }
+        while (carry) {
+            limbs.push_back(static_cast<uint32_t>(carry % kLimbBase));
+            carry /= kLimbBase;
+        }
+    }
+    
+    std::string result(zeros, '1');
+    result.reserve(zeros + limbs.size() * 5);
+    for (size_t i = limbs.size(); i-- > 0;) {
+        char digits[5];
+        uint32_t limb = limbs[i];
+        for (int d = 4; d >= 0; d--) {
+            digits[d] = kAlphabet[limb % 58];
+            limb /= 58;
+        }
         
-        std::ostringstream oss;
-        for (int i = 0; i < SHA256_DIGEST_LENGTH; i++) {
-            oss << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(hash[i]);
+        // The most significant limb is written without its leading zero digits
+        int start = 0;
+        if (i + 1 == limbs.size()) {
+            while (start < 4 && digits[start] == '1') {
+                start++;
+            }
         }
-        return oss.str();
+        result.append(digits + start, 5 - start);
     }
     
-    unsigned char hash[SHA256_DIGEST_LENGTH];
-    SHA256_CTX sha256;
+    return result;
+}
+
+void SHA256Hex(const uint8_t* data, size_t size, std::array<char, 64>& out) {
+    // One hasher per thread keeps the EVP context alive across calls
+    thread_local Sha256Hasher hasher;
+    hasher.Update(data, size);
+    hasher.FinalHex(out);
+}
+
+std::string SHA256Hex(const std::vector<uint8_t>& data) {
+    std::array<char, 64> hex;
+    SHA256Hex(data.data(), data.size(), hex);
+    return std::string(hex.data(), hex.size());
+}
+
+// Decode the envelope's Message field according to encoding.
+// Sets payload to either the original string or the decoded bytes held in buffer.
+// Validation and decoding are a single strict pass, so Auto costs no more than
+// Base64 and gives up at the first byte that is not canonical base64.
+static bool DecodeMessageField(std::string_view message_str,
+                               PayloadEncoding encoding,
+                               std::vector<uint8_t>& buffer,
+                               std::string_view& payload) {
+    payload = message_str;
+    
+    if (encoding == PayloadEncoding::Raw || message_str.empty()) {
+        return true;
+    }
     
-    SHA256_Init(&sha256);
-    SHA256_Update(&sha256, data.data(), data.size());
-    SHA256_Final(hash, &sha256);
+    // Grow only; the buffer is reused across messages
+    size_t max_size = Base64DecodedMaxSize(message_str.size());
+    if (buffer.size() < max_size) {
+        buffer.resize(max_size);
+    }
     
-    std::ostringstream oss;
-    for (int i = 0; i < SHA256_DIGEST_LENGTH; i++) {
-        oss << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(hash[i]);
+    Base64Result result = Base64Decode(message_str, buffer.data(), true);
+    if (result.status != Base64Status::Ok) {
+        // Auto falls back to the raw string
+        return encoding == PayloadEncoding::Auto;
     }
     
-    return oss.str();
+    payload = std::string_view(reinterpret_cast<const char*>(buffer.data()), result.written);
+    return true;
 }
 
-P2PMessage ParseMessage(const std::vector<uint8_t>& json_data) {
-    P2PMessage msg;
+// Single-pass scanner for the node's fixed JSON message envelope:
+//   {"MessageID": "...", "Topic": "...", "Message": "...", "SourceNodeID": "..."}
+// Strings without escape sequences are returned as views into the input;
+// escaped strings are unescaped into caller-provided storage. Members other
+// than the four envelope fields are skipped. Reports errors by return value.
+class EnvelopeScanner {
+public:
+    explicit EnvelopeScanner(std::string_view input)
+        : p_(input.data()), end_(input.data() + input.size()) {}
     
-    try {
-        std::string json_str(json_data.begin(), json_data.end());
-        nlohmann::json j = nlohmann::json::parse(json_str);
+    bool AtEnd() {
+        SkipWhitespace();
+        return p_ == end_;
+    }
+    
+    bool Consume(char expected) {
+        SkipWhitespace();
+        if (p_ == end_ || *p_ != expected) {
+            return false;
+        }
+        ++p_;
+        return true;
+    }
+    
+    bool PeekString() {
+        SkipWhitespace();
+        return p_ != end_ && *p_ == '"';
+    }
+    
+    // Scan a string value; out refers to the input or to storage
+    bool ScanString(std::string_view& out, std::string& storage) {
+        if (!Consume('"')) {
+            return false;
+        }
         
-        // Extract fields
-        if (j.contains("MessageID")) {
-            msg.message_id = j["MessageID"].get<std::string>();
+        const char* start = p_;
+        const char* quote = static_cast<const char*>(std::memchr(p_, '"', end_ - p_));
+        if (!quote) {
+            return false;
         }
-        if (j.contains("Topic")) {
-            msg.topic = j["Topic"].get<std::string>();
+        
+        const char* escape = static_cast<const char*>(std::memchr(p_, '\\', quote - p_));
+        if (!escape) {
+            // Fast path: no escape sequences, borrow from the input
+            out = std::string_view(start, quote - start);
+            p_ = quote + 1;
+            return true;
         }
-        if (j.contains("SourceNodeID")) {
-            msg.source_node_id = j["SourceNodeID"].get<std::string>();
+        
+        storage.assign(start, escape - start);
+        p_ = escape;
+        
+        while (p_ != end_) {
+            char c = *p_++;
+            if (c == '"') {
+                out = storage;
+                return true;
+            }
+            if (c != '\\') {
+                storage.push_back(c);
+                continue;
+            }
+            if (p_ == end_ || !AppendEscape(storage)) {
+                return false;
+            }
         }
         
-        // Handle Message field - can be base64 encoded string or plain string
-        if (j.contains("Message")) {
-            if (j["Message"].is_string()) {
-                std::string message_str = j["Message"].get<std::string>();
-                
-                // Simple heuristic: if string contains only base64 chars and has '=' or is multiple of 4,
-                // try decoding as base64
-                bool try_base64 = false;
-                if (!message_str.empty()) {
-                    bool all_base64_chars = true;
-                    for (char c : message_str) {
-                        if (!std::isalnum(c) && c != '+' && c != '/' && c != '=') {
-                            all_base64_chars = false;
-                            break;
-                        }
-                    }
-                    // Try base64 if it looks like base64 (has = or is multiple of 4) and contains + or /
-                    if (all_base64_chars && (message_str.find('=') != std::string::npos || 
-                        (message_str.find('+') != std::string::npos || message_str.find('/') != std::string::npos) ||
-                        message_str.length() % 4 == 0)) {
-                        try_base64 = true;
-                    }
+        return false;
+    }
+    
+    // Skip any JSON value
+    bool SkipValue(int depth = 0) {
+        if (depth > kMaxDepth) {
+            return false;
+        }
+        
+        SkipWhitespace();
+        if (p_ == end_) {
+            return false;
+        }
+        
+        switch (*p_) {
+            case '"':
+                return SkipString();
+            case '{':
+            case '[': {
+                char close = (*p_ == '{') ? '}' : ']';
+                bool is_object = (close == '}');
+                ++p_;
+                if (Consume(close)) {
+                    return true;
                 }
-                
-                if (try_base64) {
-                    std::vector<uint8_t> decoded = base64_decode(message_str);
-                    // Use decoded if it's not empty and shorter than original (base64 expands data)
-                    if (!decoded.empty() && decoded.size() < message_str.size()) {
-                        msg.message = decoded;
-                    } else {
-                        // Treat as plain text
-                        msg.message.assign(message_str.begin(), message_str.end());
+                do {
+                    if (is_object && (!SkipString() || !Consume(':'))) {
+                        return false;
+                    }
+                    if (!SkipValue(depth + 1)) {
+                        return false;
                     }
-                } else {
-                    // Treat as plain text
-                    msg.message.assign(message_str.begin(), message_str.end());
+                } while (Consume(','));
+                return Consume(close);
+            }
+            case 't':
+                return SkipLiteral("true");
+            case 'f':
+                return SkipLiteral("false");
+            case 'n':
+                return SkipLiteral("null");
+            default:
+                return SkipNumber();
+        }
+    }
+
+private:
+    static constexpr int kMaxDepth = 64;
+    
+    void SkipWhitespace() {
+        while (p_ != end_ && (*p_ == ' ' || *p_ == '\n' || *p_ == '\r' || *p_ == '\t')) {
+            ++p_;
+        }
+    }
+    
+    bool SkipString() {
+        SkipWhitespace();
+        if (p_ == end_ || *p_ != '"') {
+            return false;
+        }
+        
+        for (++p_; p_ != end_; ++p_) {
+            if (*p_ == '\\') {
+                if (++p_ == end_) {
+                    return false;
                 }
+            } else if (*p_ == '"') {
+                ++p_;
+                return true;
+            }
+        }
+        
+        return false;
+    }
+    
+    bool SkipLiteral(std::string_view literal) {
+        if (static_cast<size_t>(end_ - p_) < literal.size() ||
+            std::string_view(p_, literal.size()) != literal) {
+            return false;
+        }
+        p_ += literal.size();
+        return true;
+    }
+    
+    bool SkipNumber() {
+        const char* start = p_;
+        while (p_ != end_ && (std::isdigit(static_cast<unsigned char>(*p_)) ||
+                              *p_ == '-' || *p_ == '+' || *p_ == '.' || *p_ == 'e' || *p_ == 'E')) {
+            ++p_;
+        }
+        return p_ != start;
+    }
+    
+    bool ScanHex4(uint32_t& value) {
+        if (end_ - p_ < 4) {
+            return false;
+        }
+        
+        value = 0;
+        for (int i = 0; i < 4; i++) {
+            char c = *p_++;
+            value <<= 4;
+            if (c >= '0' && c <= '9') {
+                value |= c - '0';
+            } else if (c >= 'a' && c <= 'f') {
+                value |= c - 'a' + 10;
+            } else if (c >= 'A' && c <= 'F') {
+                value |= c - 'A' + 10;
+            } else {
+                return false;
             }
         }
-    } catch (const nlohmann::json::exception&) {
-        // Return empty message on parse error
+        
+        return true;
     }
     
-    return msg;
+    // Decode the escape sequence following a backslash
+    bool AppendEscape(std::string& out) {
+        char c = *p_++;
+        switch (c) {
+            case '"': out.push_back('"'); return true;
+            case '\\': out.push_back('\\'); return true;
+            case '/': out.push_back('/'); return true;
+            case 'b': out.push_back('\b'); return true;
+            case 'f': out.push_back('\f'); return true;
+            case 'n': out.push_back('\n'); return true;
+            case 'r': out.push_back('\r'); return true;
+            case 't': out.push_back('\t'); return true;
+            case 'u': break;
+            default: return false;
+        }
+        
+        uint32_t cp = 0;
+        if (!ScanHex4(cp)) {
+            return false;
+        }
+        
+        if (cp >= 0xD800 && cp <= 0xDBFF) {
+            // High surrogate, must be followed by an escaped low surrogate
+            uint32_t low = 0;
+            if (end_ - p_ < 2 || p_[0] != '\\' || p_[1] != 'u') {
+                return false;
+            }
+            p_ += 2;
+            if (!ScanHex4(low) || low < 0xDC00 || low > 0xDFFF) {
+                return false;
+            }
+            cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+        } else if (cp >= 0xDC00 && cp <= 0xDFFF) {
+            return false;
+        }
+        
+        // Encode as UTF-8
+        if (cp < 0x80) {
+            out.push_back(static_cast<char>(cp));
+        } else if (cp < 0x800) {
+            out.push_back(static_cast<char>(0xC0 | (cp >> 6)));
+            out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+        } else if (cp < 0x10000) {
+            out.push_back(static_cast<char>(0xE0 | (cp >> 12)));
+            out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+        } else {
+            out.push_back(static_cast<char>(0xF0 | (cp >> 18)));
+            out.push_back(static_cast<char>(0x80 | ((cp >> 12) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+        }
+        
+        return true;
+    }
+    
+    const char* p_;
+    const char* end_;
+};
+
+struct MessageDecoder::Impl {
+    // Backing storage for fields that contained escape sequences
+    std::string key;
+    std::string message_id;
+    std::string topic;
+    std::string message;
+    std::string source_node_id;
+    std::vector<uint8_t> payload_buffer;
+};
+
+MessageDecoder::MessageDecoder() : impl_(std::make_unique<Impl>()) {}
+
+MessageDecoder::~MessageDecoder() = default;
+
+bool MessageDecoder::Decode(std::string_view json_data, P2PMessageView& view, PayloadEncoding encoding) {
+    view = P2PMessageView();
+    
+    EnvelopeScanner scanner(json_data);
+    std::string_view message;
+    bool has_message = false;
+    
+    if (!scanner.Consume('{')) {
+        return false;
+    }
+    
+    if (!scanner.Consume('}')) {
+        do {
+            std::string_view key;
+            if (!scanner.ScanString(key, impl_->key) || !scanner.Consume(':')) {
+                view = P2PMessageView();
+                return false;
+            }
+            
+            // Only string values are extracted, anything else is skipped
+            bool ok = true;
+            if (!scanner.PeekString()) {
+                ok = scanner.SkipValue();
+            } else if (key == "MessageID") {
+                ok = scanner.ScanString(view.message_id, impl_->message_id);
+            } else if (key == "Topic") {
+                ok = scanner.ScanString(view.topic, impl_->topic);
+            } else if (key == "SourceNodeID") {
+                ok = scanner.ScanString(view.source_node_id, impl_->source_node_id);
+            } else if (key == "Message") {
+                ok = scanner.ScanString(message, impl_->message);
+                has_message = true;
+            } else {
+                ok = scanner.SkipValue();
+            }
+            
+            if (!ok) {
+                view = P2PMessageView();
+                return false;
+            }
+        } while (scanner.Consume(','));
+        
+        if (!scanner.Consume('}')) {
+            view = P2PMessageView();
+            return false;
+        }
+    }
+    
+    if (!scanner.AtEnd()) {
+        view = P2PMessageView();
+        return false;
+    }
+    
+    if (has_message && !DecodeMessageField(message, encoding, impl_->payload_buffer, view.message)) {
+        view = P2PMessageView();
+        return false;
+    }
+    
+    return true;
+}
+
+P2PMessage ParseMessage(const std::vector<uint8_t>& json_data, PayloadEncoding encoding) {
+    return ParseMessage(std::string_view(reinterpret_cast<const char*>(json_data.data()), json_data.size()),
+                        encoding);
+}
+
+P2PMessage ParseMessage(std::string_view json_data, PayloadEncoding encoding) {
+    thread_local MessageDecoder decoder;
+    
+    // Return empty message on parse error
+    P2PMessageView view;
+    decoder.Decode(json_data, view, encoding);
+    
+    return view.ToOwned();
 }
 
 void HandleGossipSubTrace(const std::vector<uint8_t>& data, 
                          bool write_trace,
                          std::function<void(const std::string&)> trace_callback) {
-    // For Phase 2, this is a placeholder
-    // Full implementation requires protobuf parsing of GossipSub trace events
-    // This will be implemented when trace handling is needed
-    if (trace_callback) {
-        std::string hex_preview = HeadHex(data, 64);
-        trace_callback("[GossipSub Trace] " + hex_preview + "...");
+    HandleGossipSubTrace(std::string_view(reinterpret_cast<const char*>(data.data()), data.size()),
+                         write_trace, trace_callback);
+}
+
+void HandleGossipSubTrace(std::string_view data,
+                         bool write_trace,
+                         std::function<void(const std::string&)> trace_callback) {
+    if (!trace_callback) {
+        return;
     }
+    
+    using pubsub::pb::TraceEvent;
+    thread_local TraceEvent event;
+    
+    if (!event.ParseFromArray(data.data(), static_cast<int>(data.size())) || !event.has_type()) {
+        if (!write_trace) {
+            size_t len = std::min<size_t>(data.size(), 64);
+            std::string hex(2 * len, '\0');
+            HexEncode(reinterpret_cast<const uint8_t*>(data.data()), len, hex.data());
+            trace_callback("[GossipSub Trace] undecodable event: " + hex);
+        }
+        return;
+    }
+    
+    // Message-level fields depend on the event type
+    const std::string* message_id = nullptr;
+    const std::string* received_from = nullptr;
+    const std::string* topic = nullptr;
+    switch (event.type()) {
+        case TraceEvent::PUBLISH_MESSAGE:
+            message_id = &event.publishmessage().messageid();
+            topic = &event.publishmessage().topic();
+            break;
+        case TraceEvent::REJECT_MESSAGE:
+            message_id = &event.rejectmessage().messageid();
+            received_from = &event.rejectmessage().receivedfrom();
+            topic = &event.rejectmessage().topic();
+            break;
+        case TraceEvent::DUPLICATE_MESSAGE:
+            message_id = &event.duplicatemessage().messageid();
+            received_from = &event.duplicatemessage().receivedfrom();
+            topic = &event.duplicatemessage().topic();
+            break;
+        case TraceEvent::DELIVER_MESSAGE:
+            message_id = &event.delivermessage().messageid();
+            received_from = &event.delivermessage().receivedfrom();
+            topic = &event.delivermessage().topic();
+            break;
+        case TraceEvent::GRAFT:
+            received_from = &event.graft().peerid();
+            topic = &event.graft().topic();
+            break;
+        case TraceEvent::PRUNE:
+            received_from = &event.prune().peerid();
+            topic = &event.prune().topic();
+            break;
+        case TraceEvent::JOIN:
+            topic = &event.join().topic();
+            break;
+        case TraceEvent::LEAVE:
+            topic = &event.leave().topic();
+            break;
+        default:
+            break;
+    }
+    
+    const std::string& type = TraceEvent::Type_Name(event.type());
+    const std::string& peer_id = event.peerid();
+    std::string peer = Base58Encode(reinterpret_cast<const uint8_t*>(peer_id.data()), peer_id.size());
+    std::string from = received_from
+        ? Base58Encode(reinterpret_cast<const uint8_t*>(received_from->data()), received_from->size())
+        : std::string();
+    std::string id;
+    if (message_id) {
+        id.resize(2 * message_id->size());
+        HexEncode(reinterpret_cast<const uint8_t*>(message_id->data()), message_id->size(), id.data());
+    }
+    
+    std::string line;
+    if (write_trace) {
+        line.reserve(type.size() + peer.size() + from.size() + id.size() + 64);
+        line.append(type).append("\t").append(peer).append("\t").append(from).append("\t");
+        line.append(id).append("\t").append(topic ? *topic : std::string()).append("\t");
+        line.append(std::to_string(event.timestamp()));
+    } else {
+        line = "[GossipSub Trace] " + type + " peer=" + peer;
+        if (topic) {
+            line += " topic=" + *topic;
+        }
+        if (message_id) {
+            line += " msg=" + id;
+        }
+        if (received_from) {
+            line += " from=" + from;
+        }
+        line += " ts=" + std::to_string(event.timestamp());
+    }
+    
+    trace_callback(line);
 }
 
 void HandleOptimumP2PTrace(const std::vector<uint8_t>& data,
                           bool write_trace,
                           std::function<void(const std::string&)> trace_callback) {
-    // For Phase 2, this is a placeholder
-    // Full implementation requires protobuf parsing of mump2p trace events
-    // This will be implemented when trace handling is needed
-    if (trace_callback) {
-        std::string hex_preview = HeadHex(data, 64);
-        trace_callback("[mump2p Trace] " + hex_preview + "...");
+    HandleOptimumP2PTrace(std::string_view(reinterpret_cast<const char*>(data.data()), data.size()),
+                          write_trace, trace_callback);
+}
+
+void HandleOptimumP2PTrace(std::string_view data,
+                          bool write_trace,
+                          std::function<void(const std::string&)> trace_callback) {
+    if (!trace_callback) {
+        return;
+    }
+    
+    MumP2PTraceEvent event;
+    if (!DecodeMumP2PTrace(data, event)) {
+        if (!write_trace) {
+            size_t len = std::min<size_t>(data.size(), 64);
+            std::string hex(2 * len, '\0');
+            HexEncode(reinterpret_cast<const uint8_t*>(data.data()), len, hex.data());
+            trace_callback("[mump2p Trace] undecodable event: " + hex);
+        }
+        return;
+    }
+    
+    std::string type = std::to_string(event.type);
+    std::string peer = Base58Encode(reinterpret_cast<const uint8_t*>(event.peer_id.data()), event.peer_id.size());
+    std::string id(2 * event.message_id.size(), '\0');
+    HexEncode(reinterpret_cast<const uint8_t*>(event.message_id.data()), event.message_id.size(), id.data());
+    
+    std::string line;
+    if (write_trace) {
+        line.reserve(type.size() + peer.size() + id.size() + 32);
+        line.append(type).append("\t").append(peer).append("\t\t").append(id).append("\t\t");
+        line.append(std::to_string(event.timestamp));
+    } else {
+        line = "[mump2p Trace] type=" + type + " peer=" + peer;
+        if (!id.empty()) {
+            line += " msg=" + id;
+        }
+        line += " ts=" + std::to_string(event.timestamp);
     }
+    
+    trace_callback(line);
 }
 
 void WriteToFile(const std::string& filename, 
@@ -200,13 +667,9 @@ void WriteToFile(const std::string& filename,
 
 std::string HeadHex(const std::vector<uint8_t>& data, size_t n) {
     size_t len = std::min(data.size(), n);
-    std::ostringstream oss;
-    
-    for (size_t i = 0; i < len; i++) {
-        oss << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(data[i]);
-    }
-    
-    return oss.str();
+    std::string hex(2 * len, '\0');
+    HexEncode(data.data(), len, hex.data());
+    return hex;
 }
 
 } // namespace optimum_p2p
@@ -0,0 +1,379 @@
+// In-process fake CommandStream node
+
+#include "fake_node.hpp"
+#include "optimum_p2p/types.hpp"
+#include "trace.pb.h"
+#include <nlohmann/json.hpp>
+
+namespace optimum_p2p {
+namespace fake {
+
+namespace {
+
+// Go's encoding/json writes []byte as padded standard base64
+std::string Base64Encode(const std::string& data) {
+    static const char* kAlphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    
+    std::string out;
+    out.reserve((data.size() + 2) / 3 * 4);
+    size_t i = 0;
+    for (; i + 2 < data.size(); i += 3) {
+        uint32_t n = (uint8_t(data[i]) << 16) | (uint8_t(data[i + 1]) << 8) | uint8_t(data[i + 2]);
+        out.push_back(kAlphabet[(n >> 18) & 63]);
+        out.push_back(kAlphabet[(n >> 12) & 63]);
+        out.push_back(kAlphabet[(n >> 6) & 63]);
+        out.push_back(kAlphabet[n & 63]);
+    }
+    if (i + 1 == data.size()) {
+        uint32_t n = uint8_t(data[i]) << 16;
+        out.push_back(kAlphabet[(n >> 18) & 63]);
+        out.push_back(kAlphabet[(n >> 12) & 63]);
+        out.append("==");
+    } else if (i + 2 == data.size()) {
+        uint32_t n = (uint8_t(data[i]) << 16) | (uint8_t(data[i + 1]) << 8);
+        out.push_back(kAlphabet[(n >> 18) & 63]);
+        out.push_back(kAlphabet[(n >> 12) & 63]);
+        out.push_back(kAlphabet[(n >> 6) & 63]);
+        out.push_back('=');
+    }
+    return out;
+}
+
+} // namespace
+
+PayloadSizes PayloadSizes::Fixed(size_t size) {
+    return Uniform(size, size);
+}
+
+PayloadSizes PayloadSizes::Uniform(size_t min, size_t max) {
+    PayloadSizes sizes;
+    sizes.min = min;
+    sizes.max = max < min ? min : max;
+    return sizes;
+}
+
+PayloadSizes PayloadSizes::Weighted(std::vector<std::pair<size_t, double>> weighted) {
+    PayloadSizes sizes;
+    sizes.weighted = std::move(weighted);
+    return sizes;
+}
+
+DeliveryScheduler::DeliveryScheduler()
+    : next_sequence_(0), stop_(false) {
+    thread_ = std::thread([this]() {
+        this->Run();
+    });
+}
+
+DeliveryScheduler::~DeliveryScheduler() {
+    Stop();
+}
+
+void DeliveryScheduler::Schedule(std::chrono::steady_clock::time_point due, std::function<void()> job) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stop_) {
+            return;
+        }
+        jobs_.push(Job{due, next_sequence_++, std::move(job)});
+    }
+    cv_.notify_one();
+}
+
+void DeliveryScheduler::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    cv_.notify_one();
+    
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+void DeliveryScheduler::Run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stop_) {
+        if (jobs_.empty()) {
+            cv_.wait(lock);
+            continue;
+        }
+        
+        auto due = jobs_.top().due;
+        if (std::chrono::steady_clock::now() < due) {
+            cv_.wait_until(lock, due);
+            continue;
+        }
+        
+        std::function<void()> job = std::move(const_cast<Job&>(jobs_.top()).run);
+        jobs_.pop();
+        lock.unlock();
+        job();
+        lock.lock();
+    }
+}
+
+FakeNode::FakeNode(FakeNodeOptions options)
+    : options_(std::move(options)),
+      rng_(options_.seed),
+      next_message_id_(0),
+      published_(0),
+      generated_(0),
+      delivered_(0),
+      generator_running_(false) {
+    if (options_.fan_out < 1) {
+        options_.fan_out = 1;
+    }
+}
+
+FakeNode::~FakeNode() {
+    Stop();
+}
+
+bool FakeNode::Start(const std::string& address) {
+    int port = 0;
+    grpc::ServerBuilder builder;
+    builder.AddListeningPort(address, grpc::InsecureServerCredentials(), &port);
+    builder.RegisterService(this);
+    builder.SetMaxReceiveMessageSize(INT32_MAX);
+    builder.SetMaxSendMessageSize(INT32_MAX);
+    
+    server_ = builder.BuildAndStart();
+    if (!server_ || port == 0) {
+        server_.reset();
+        return false;
+    }
+    
+    address_ = address.substr(0, address.rfind(':') + 1) + std::to_string(port);
+    return true;
+}
+
+void FakeNode::Stop() {
+    StopGenerator();
+    scheduler_.Stop();
+    
+    if (server_) {
+        // Streams stay open until clients close them; give them a deadline
+        server_->Shutdown(std::chrono::system_clock::now() + std::chrono::seconds(1));
+        server_.reset();
+    }
+}
+
+void FakeNode::Inject(const std::string& topic, const std::string& payload) {
+    Publish(topic, payload);
+}
+
+bool FakeNode::WaitForSubscribers(const std::string& topic, size_t count, std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return subscribed_.wait_for(lock, timeout, [&]() {
+        auto it = subscribers_.find(topic);
+        return it != subscribers_.end() && it->second.size() >= count;
+    });
+}
+
+size_t FakeNode::Subscribers(const std::string& topic) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = subscribers_.find(topic);
+    return it == subscribers_.end() ? 0 : it->second.size();
+}
+
+grpc::Status FakeNode::ListenCommands(grpc::ServerContext* /*context*/,
+                                      grpc::ServerReaderWriter<proto::Response, proto::Request>* stream) {
+    auto session = std::make_shared<Session>();
+    session->stream = stream;
+    
+    proto::Request request;
+    while (stream->Read(&request)) {
+        switch (static_cast<Command>(request.command())) {
+            case Command::SubscribeToTopic: {
+                std::lock_guard<std::mutex> lock(mutex_);
+                subscribers_[request.topic()].insert(session);
+                subscribed_.notify_all();
+                break;
+            }
+            case Command::UnSubscribeToTopic: {
+                std::lock_guard<std::mutex> lock(mutex_);
+                subscribers_[request.topic()].erase(session);
+                break;
+            }
+            case Command::PublishData:
+                published_++;
+                Publish(request.topic(), request.data());
+                break;
+            default:
+                break;
+        }
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto& topic : subscribers_) {
+            topic.second.erase(session);
+        }
+    }
+    
+    // Pending deliveries may still hold the session; keep them off the stream
+    std::lock_guard<std::mutex> lock(session->write_mutex);
+    session->closed = true;
+    return grpc::Status::OK;
+}
+
+grpc::Status FakeNode::Health(grpc::ServerContext* /*context*/, const proto::Void* /*request*/,
+                              proto::HealthResponse* response) {
+    response->set_status(true);
+    response->set_nodemode(options_.node_mode);
+    response->set_p2paddress(address_);
+    return grpc::Status::OK;
+}
+
+grpc::Status FakeNode::ListTopics(grpc::ServerContext* /*context*/, const proto::Void* /*request*/,
+                                  proto::TopicList* response) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& topic : subscribers_) {
+        if (!topic.second.empty()) {
+            response->add_topics(topic.first);
+        }
+    }
+    return grpc::Status::OK;
+}
+
+void FakeNode::Publish(const std::string& topic, const std::string& payload) {
+    std::string message_id = options_.node_id + "-" + std::to_string(++next_message_id_);
+    
+    nlohmann::json envelope;
+    envelope["MessageID"] = message_id;
+    envelope["Topic"] = topic;
+    envelope["Message"] = options_.base64_payloads ? Base64Encode(payload) : payload;
+    envelope["SourceNodeID"] = options_.node_id;
+    
+    auto message = std::make_shared<proto::Response>();
+    message->set_command(proto::ResponseType::Message);
+    message->set_data(envelope.dump());
+    
+    std::shared_ptr<proto::Response> trace;
+    if (options_.gossipsub_traces) {
+        pubsub::pb::TraceEvent event;
+        event.set_type(pubsub::pb::TraceEvent::DELIVER_MESSAGE);
+        event.set_peerid(options_.node_id);
+        event.set_timestamp(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count());
+        event.mutable_delivermessage()->set_messageid(message_id);
+        event.mutable_delivermessage()->set_topic(topic);
+        
+        trace = std::make_shared<proto::Response>();
+        trace->set_command(proto::ResponseType::MessageTraceGossipSub);
+        trace->set_data(event.SerializeAsString());
+    }
+    
+    std::chrono::microseconds delay = NextDelay();
+    if (delay.count() == 0) {
+        Deliver(topic, message, trace);
+        return;
+    }
+    
+    scheduler_.Schedule(std::chrono::steady_clock::now() + delay, [this, topic, message, trace]() {
+        this->Deliver(topic, message, trace);
+    });
+}
+
+void FakeNode::Deliver(const std::string& topic, std::shared_ptr<const proto::Response> message,
+                       std::shared_ptr<const proto::Response> trace) {
+    std::vector<std::shared_ptr<Session>> sessions;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = subscribers_.find(topic);
+        if (it == subscribers_.end()) {
+            return;
+        }
+        sessions.assign(it->second.begin(), it->second.end());
+    }
+    
+    for (const auto& session : sessions) {
+        std::lock_guard<std::mutex> lock(session->write_mutex);
+        if (session->closed) {
+            continue;
+        }
+        for (int copy = 0; copy < options_.fan_out; copy++) {
+            if (session->stream->Write(*message)) {
+                delivered_++;
+            }
+            if (trace) {
+                session->stream->Write(*trace);
+            }
+        }
+    }
+}
+
+std::chrono::microseconds FakeNode::NextDelay() {
+    if (options_.jitter.count() == 0) {
+        return options_.latency;
+    }
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::uniform_int_distribution<int64_t> jitter(0, options_.jitter.count());
+    return options_.latency + std::chrono::microseconds(jitter(rng_));
+}
+
+void FakeNode::StartGenerator(const std::string& topic, double rate, PayloadSizes sizes) {
+    StopGenerator();
+    if (rate <= 0) {
+        return;
+    }
+    
+    generator_running_ = true;
+    generator_thread_ = std::thread([this, topic, rate, sizes]() {
+        this->GeneratorLoop(topic, rate, sizes);
+    });
+}
+
+void FakeNode::StopGenerator() {
+    generator_running_ = false;
+    if (generator_thread_.joinable()) {
+        generator_thread_.join();
+    }
+}
+
+void FakeNode::GeneratorLoop(std::string topic, double rate, PayloadSizes sizes) {
+    std::mt19937 rng(options_.seed);
+    std::uniform_int_distribution<size_t> uniform(sizes.min, sizes.max);
+    std::vector<double> weights;
+    for (const auto& size : sizes.weighted) {
+        weights.push_back(size.second);
+    }
+    std::discrete_distribution<size_t> weighted(weights.begin(), weights.end());
+    
+    std::string filler(sizes.max, 'x');
+    for (const auto& size : sizes.weighted) {
+        if (size.first > filler.size()) {
+            filler.resize(size.first, 'x');
+        }
+    }
+    
+    // Messages are due at start + n / rate; everything due is sent at once so
+    // high rates do not depend on sleep granularity
+    auto start = std::chrono::steady_clock::now();
+    uint64_t sent = 0;
+    while (generator_running_) {
+        auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        uint64_t due = static_cast<uint64_t>(elapsed * rate) + 1;
+        
+        for (; sent < due && generator_running_; sent++) {
+            size_t size = sizes.weighted.empty() ? uniform(rng) : sizes.weighted[weighted(rng)].first;
+            auto now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count();
+            
+            std::string payload = "[" + std::to_string(now) + " " + std::to_string(size) + "] ";
+            payload.append(filler, 0, size);
+            Publish(topic, payload);
+            generated_++;
+        }
+        
+        auto next = start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double>(sent / rate));
+        std::this_thread::sleep_until(std::min(next, std::chrono::steady_clock::now() + std::chrono::milliseconds(10)));
+    }
+}
+
+} // namespace fake
+} // namespace optimum_p2p
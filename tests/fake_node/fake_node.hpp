@@ -0,0 +1,153 @@
+#pragma once
+
+#include "p2p_stream.grpc.pb.h"
+#include <grpcpp/grpcpp.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <random>
+#include <set>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace optimum_p2p {
+namespace fake {
+
+// Payload sizes drawn for generated messages: uniform in [min, max], or, if
+// weighted is not empty, one of its sizes with probability proportional to
+// its weight
+struct PayloadSizes {
+    size_t min = 256;
+    size_t max = 256;
+    std::vector<std::pair<size_t, double>> weighted;
+    
+    static PayloadSizes Fixed(size_t size);
+    static PayloadSizes Uniform(size_t min, size_t max);
+    static PayloadSizes Weighted(std::vector<std::pair<size_t, double>> sizes);
+};
+
+// Behaviour shared by FakeNode and FakeProxy
+struct FakeNodeOptions {
+    std::string node_id = "fake-node";    // SourceNodeID of delivered messages
+    std::string node_mode = "gateway";    // reported by Health
+    std::chrono::microseconds latency{0}; // added before every delivery
+    std::chrono::microseconds jitter{0};  // plus a uniform random [0, jitter]
+    int fan_out = 1;                      // copies of each message per subscriber
+    bool base64_payloads = true;          // encode Message like Go's encoding/json []byte
+    bool gossipsub_traces = false;        // follow each delivery with a DELIVER_MESSAGE trace
+    uint32_t seed = 1;                    // for jitter and generated payload sizes
+};
+
+// DeliveryScheduler runs jobs at their due time, in due-time order, on one
+// background thread. Jobs still pending when it stops are dropped.
+class DeliveryScheduler {
+public:
+    DeliveryScheduler();
+    ~DeliveryScheduler();
+    
+    void Schedule(std::chrono::steady_clock::time_point due, std::function<void()> job);
+    void Stop();
+
+private:
+    struct Job {
+        std::chrono::steady_clock::time_point due;
+        uint64_t sequence; // keeps jobs with the same due time in order
+        std::function<void()> run;
+        
+        bool operator>(const Job& other) const {
+            return due != other.due ? due > other.due : sequence > other.sequence;
+        }
+    };
+    
+    void Run();
+    
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::priority_queue<Job, std::vector<Job>, std::greater<Job>> jobs_;
+    uint64_t next_sequence_;
+    bool stop_;
+    std::thread thread_;
+};
+
+// FakeNode is an in-process CommandStream node for tests and benchmarks.
+// Publish commands are delivered to every stream subscribed to the topic in
+// the node's JSON envelope, with configurable latency, jitter and fan-out.
+// A generator can publish messages at a fixed rate with varying sizes.
+class FakeNode : public proto::CommandStream::Service {
+public:
+    explicit FakeNode(FakeNodeOptions options = FakeNodeOptions());
+    ~FakeNode() override;
+    
+    // Listen on address ("127.0.0.1:0" picks a free port). Returns false if
+    // the server could not start.
+    bool Start(const std::string& address = "127.0.0.1:0");
+    void Stop();
+    
+    // host:port the node listens on, valid after Start
+    const std::string& Address() const { return address_; }
+    
+    // Deliver payload to the topic's subscribers as if published on the network
+    void Inject(const std::string& topic, const std::string& payload);
+    
+    // Publish rate messages per second on topic until StopGenerator. Payloads
+    // carry MultiPublishClient's "[<unix-nanos> <size>] " prefix followed by
+    // size bytes, so subscribers can measure latency.
+    void StartGenerator(const std::string& topic, double rate, PayloadSizes sizes = PayloadSizes());
+    void StopGenerator();
+    
+    bool WaitForSubscribers(const std::string& topic, size_t count, std::chrono::milliseconds timeout);
+    size_t Subscribers(const std::string& topic) const;
+    
+    uint64_t Published() const { return published_.load(); } // publish commands received
+    uint64_t Generated() const { return generated_.load(); } // messages from the generator
+    uint64_t Delivered() const { return delivered_.load(); } // message responses written
+    
+    grpc::Status ListenCommands(grpc::ServerContext* context,
+                                grpc::ServerReaderWriter<proto::Response, proto::Request>* stream) override;
+    grpc::Status Health(grpc::ServerContext* context, const proto::Void* request,
+                        proto::HealthResponse* response) override;
+    grpc::Status ListTopics(grpc::ServerContext* context, const proto::Void* request,
+                            proto::TopicList* response) override;
+
+private:
+    struct Session {
+        grpc::ServerReaderWriter<proto::Response, proto::Request>* stream;
+        std::mutex write_mutex;
+        bool closed = false; // guarded by write_mutex
+    };
+    
+    void Publish(const std::string& topic, const std::string& payload);
+    void Deliver(const std::string& topic, std::shared_ptr<const proto::Response> message,
+                 std::shared_ptr<const proto::Response> trace);
+    std::chrono::microseconds NextDelay();
+    void GeneratorLoop(std::string topic, double rate, PayloadSizes sizes);
+    
+    FakeNodeOptions options_;
+    std::string address_;
+    std::unique_ptr<grpc::Server> server_;
+    DeliveryScheduler scheduler_;
+    
+    mutable std::mutex mutex_;
+    std::condition_variable subscribed_;
+    std::map<std::string, std::set<std::shared_ptr<Session>>> subscribers_;
+    std::mt19937 rng_; // guarded by mutex_
+    
+    std::atomic<uint64_t> next_message_id_;
+    std::atomic<uint64_t> published_;
+    std::atomic<uint64_t> generated_;
+    std::atomic<uint64_t> delivered_;
+    
+    std::atomic<bool> generator_running_;
+    std::thread generator_thread_;
+};
+
+} // namespace fake
+} // namespace optimum_p2p
@@ -0,0 +1,409 @@
+// In-process fake Optimum Proxy
+
+#include "fake_proxy.hpp"
+#include <nlohmann/json.hpp>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <cstdlib>
+#include <cstring>
+#include <strings.h>
+
+namespace optimum_p2p {
+namespace fake {
+
+namespace {
+
+const char* StatusText(int status) {
+    switch (status) {
+        case 200: return "OK";
+        case 400: return "Bad Request";
+        case 404: return "Not Found";
+        default: return "Error";
+    }
+}
+
+bool SendAll(int fd, const std::string& data) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t n = send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (n <= 0) {
+            return false;
+        }
+        sent += n;
+    }
+    return true;
+}
+
+// Value of a header in the request head, empty if absent
+std::string HeaderValue(const std::string& head, const char* name) {
+    size_t name_len = strlen(name);
+    size_t pos = head.find("\r\n");
+    while (pos != std::string::npos && pos + 2 < head.size()) {
+        size_t line = pos + 2;
+        size_t end = head.find("\r\n", line);
+        if (end == std::string::npos) {
+            end = head.size();
+        }
+        if (end - line > name_len && head[line + name_len] == ':' &&
+            strncasecmp(head.c_str() + line, name, name_len) == 0) {
+            size_t value = head.find_first_not_of(' ', line + name_len + 1);
+            return value < end ? head.substr(value, end - value) : std::string();
+        }
+        pos = end;
+    }
+    return std::string();
+}
+
+} // namespace
+
+FakeProxy::FakeProxy(FakeNodeOptions options)
+    : options_(std::move(options)),
+      rng_(options_.seed),
+      next_message_id_(0),
+      published_(0),
+      delivered_(0),
+      accepted_(0),
+      listen_fd_(-1),
+      running_(false) {
+    if (options_.fan_out < 1) {
+        options_.fan_out = 1;
+    }
+}
+
+FakeProxy::~FakeProxy() {
+    Stop();
+}
+
+bool FakeProxy::Start(const std::string& grpc_address) {
+    int port = 0;
+    grpc::ServerBuilder builder;
+    builder.AddListeningPort(grpc_address, grpc::InsecureServerCredentials(), &port);
+    builder.RegisterService(this);
+    builder.SetMaxReceiveMessageSize(INT32_MAX);
+    builder.SetMaxSendMessageSize(INT32_MAX);
+    
+    server_ = builder.BuildAndStart();
+    if (!server_ || port == 0) {
+        server_.reset();
+        return false;
+    }
+    grpc_address_ = grpc_address.substr(0, grpc_address.rfind(':') + 1) + std::to_string(port);
+    
+    listen_fd_ = socket(AF_INET, SOCK_STREAM, 0);
+    if (listen_fd_ < 0) {
+        Stop();
+        return false;
+    }
+    
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = 0;
+    socklen_t addr_len = sizeof(addr);
+    if (bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        listen(listen_fd_, 64) != 0 ||
+        getsockname(listen_fd_, reinterpret_cast<sockaddr*>(&addr), &addr_len) != 0) {
+        Stop();
+        return false;
+    }
+    rest_url_ = "http://127.0.0.1:" + std::to_string(ntohs(addr.sin_port));
+    
+    running_ = true;
+    accept_thread_ = std::thread([this]() {
+        this->AcceptLoop();
+    });
+    return true;
+}
+
+void FakeProxy::Stop() {
+    running_ = false;
+    if (listen_fd_ >= 0) {
+        // Wakes accept()
+        shutdown(listen_fd_, SHUT_RDWR);
+    }
+    if (accept_thread_.joinable()) {
+        accept_thread_.join();
+    }
+    if (listen_fd_ >= 0) {
+        close(listen_fd_);
+        listen_fd_ = -1;
+    }
+    
+    std::list<std::unique_ptr<Connection>> connections;
+    {
+        std::lock_guard<std::mutex> lock(connections_mutex_);
+        for (auto& connection : connections_) {
+            if (!connection->done) {
+                shutdown(connection->fd, SHUT_RDWR);
+            }
+        }
+        connections.swap(connections_);
+    }
+    for (auto& connection : connections) {
+        connection->thread.join();
+    }
+    
+    scheduler_.Stop();
+    
+    if (server_) {
+        server_->Shutdown(std::chrono::system_clock::now() + std::chrono::seconds(1));
+        server_.reset();
+    }
+}
+
+void FakeProxy::Inject(const std::string& topic, const std::string& payload) {
+    Publish(topic, payload);
+}
+
+bool FakeProxy::WaitForClients(const std::string& topic, size_t count, std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return changed_.wait_for(lock, timeout, [&]() {
+        return ConnectedClients(topic) >= count;
+    });
+}
+
+size_t FakeProxy::ConnectedClients(const std::string& topic) const {
+    auto it = subscriptions_.find(topic);
+    if (it == subscriptions_.end()) {
+        return 0;
+    }
+    
+    size_t count = 0;
+    for (const auto& client_id : it->second) {
+        count += sessions_.count(client_id);
+    }
+    return count;
+}
+
+grpc::Status FakeProxy::ClientStream(grpc::ServerContext* /*context*/,
+                                     grpc::ServerReaderWriter<proto::ProxyMessage, proto::ProxyMessage>* stream) {
+    // The first message carries the client ID; later ones are ignored
+    proto::ProxyMessage hello;
+    if (!stream->Read(&hello) || hello.client_id().empty()) {
+        return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, "missing client_id");
+    }
+    
+    auto session = std::make_shared<Session>();
+    session->stream = stream;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        sessions_[hello.client_id()] = session;
+        changed_.notify_all();
+    }
+    
+    proto::ProxyMessage ignored;
+    while (stream->Read(&ignored)) {
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = sessions_.find(hello.client_id());
+        if (it != sessions_.end() && it->second == session) {
+            sessions_.erase(it);
+        }
+    }
+    
+    std::lock_guard<std::mutex> lock(session->write_mutex);
+    session->closed = true;
+    return grpc::Status::OK;
+}
+
+void FakeProxy::Publish(const std::string& topic, const std::string& payload) {
+    auto message = std::make_shared<proto::ProxyMessage>();
+    message->set_message(payload);
+    message->set_topic(topic);
+    message->set_message_id(options_.node_id + "-" + std::to_string(++next_message_id_));
+    message->set_type("message");
+    
+    std::chrono::microseconds delay = options_.latency;
+    if (options_.jitter.count() > 0) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::uniform_int_distribution<int64_t> jitter(0, options_.jitter.count());
+        delay += std::chrono::microseconds(jitter(rng_));
+    }
+    
+    if (delay.count() == 0) {
+        Deliver(message);
+        return;
+    }
+    
+    scheduler_.Schedule(std::chrono::steady_clock::now() + delay, [this, message]() {
+        this->Deliver(message);
+    });
+}
+
+void FakeProxy::Deliver(std::shared_ptr<const proto::ProxyMessage> message) {
+    std::vector<std::pair<std::string, std::shared_ptr<Session>>> targets;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = subscriptions_.find(message->topic());
+        if (it == subscriptions_.end()) {
+            return;
+        }
+        for (const auto& client_id : it->second) {
+            auto session = sessions_.find(client_id);
+            if (session != sessions_.end()) {
+                targets.emplace_back(client_id, session->second);
+            }
+        }
+    }
+    
+    proto::ProxyMessage out(*message);
+    for (const auto& target : targets) {
+        out.set_client_id(target.first);
+        
+        std::lock_guard<std::mutex> lock(target.second->write_mutex);
+        if (target.second->closed) {
+            continue;
+        }
+        for (int copy = 0; copy < options_.fan_out; copy++) {
+            if (target.second->stream->Write(out)) {
+                delivered_++;
+            }
+        }
+    }
+}
+
+void FakeProxy::AcceptLoop() {
+    while (running_) {
+        int fd = accept(listen_fd_, nullptr, nullptr);
+        if (fd < 0) {
+            if (!running_) {
+                break;
+            }
+            continue;
+        }
+        
+        accepted_++;
+        
+        std::lock_guard<std::mutex> lock(connections_mutex_);
+        for (auto it = connections_.begin(); it != connections_.end();) {
+            if ((*it)->done) {
+                (*it)->thread.join();
+                it = connections_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        
+        auto connection = std::make_unique<Connection>();
+        connection->fd = fd;
+        Connection* c = connection.get();
+        connection->thread = std::thread([this, c]() {
+            this->ServeConnection(*c);
+        });
+        connections_.push_back(std::move(connection));
+    }
+}
+
+void FakeProxy::ServeConnection(Connection& connection) {
+    int fd = connection.fd;
+    std::string buffer;
+    char chunk[16384];
+    
+    // HTTP/1.1 keep-alive: serve requests until the client closes
+    while (running_) {
+        size_t head_end;
+        while ((head_end = buffer.find("\r\n\r\n")) == std::string::npos) {
+            ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+            if (n <= 0) {
+                head_end = std::string::npos;
+                break;
+            }
+            buffer.append(chunk, n);
+        }
+        if (head_end == std::string::npos) {
+            break;
+        }
+        
+        std::string head = buffer.substr(0, head_end);
+        buffer.erase(0, head_end + 4);
+        
+        size_t method_end = head.find(' ');
+        size_t path_end = head.find(' ', method_end + 1);
+        if (method_end == std::string::npos || path_end == std::string::npos) {
+            break;
+        }
+        std::string method = head.substr(0, method_end);
+        std::string path = head.substr(method_end + 1, path_end - method_end - 1);
+        
+        size_t content_length = strtoull(HeaderValue(head, "Content-Length").c_str(), nullptr, 10);
+        if (strcasecmp(HeaderValue(head, "Expect").c_str(), "100-continue") == 0 &&
+            !SendAll(fd, "HTTP/1.1 100 Continue\r\n\r\n")) {
+            break;
+        }
+        
+        bool closed = false;
+        while (buffer.size() < content_length) {
+            ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+            if (n <= 0) {
+                closed = true;
+                break;
+            }
+            buffer.append(chunk, n);
+        }
+        if (closed) {
+            break;
+        }
+        
+        std::string body = buffer.substr(0, content_length);
+        buffer.erase(0, content_length);
+        
+        std::string response_body;
+        int status = HandleRequest(method, path, body, response_body);
+        
+        std::string response = "HTTP/1.1 " + std::to_string(status) + " " + StatusText(status) + "\r\n" +
+                               "Content-Type: application/json\r\n" +
+                               "Content-Length: " + std::to_string(response_body.size()) + "\r\n\r\n" +
+                               response_body;
+        if (!SendAll(fd, response)) {
+            break;
+        }
+    }
+    
+    std::lock_guard<std::mutex> lock(connections_mutex_);
+    close(fd);
+    connection.done = true;
+}
+
+int FakeProxy::HandleRequest(const std::string& method, const std::string& path, const std::string& body,
+                             std::string& response) {
+    bool subscribe = path == "/api/v1/subscribe";
+    bool publish = path == "/api/v1/publish";
+    if (method != "POST" || (!subscribe && !publish)) {
+        response = R"({"error":"not found"})";
+        return 404;
+    }
+    
+    auto request = nlohmann::json::parse(body, nullptr, false);
+    if (request.is_discarded() || !request.is_object() ||
+        !request.contains("client_id") || !request["client_id"].is_string() ||
+        !request.contains("topic") || !request["topic"].is_string()) {
+        response = R"({"error":"bad request"})";
+        return 400;
+    }
+    std::string client_id = request["client_id"].get<std::string>();
+    std::string topic = request["topic"].get<std::string>();
+    
+    if (subscribe) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        subscriptions_[topic].insert(client_id);
+        changed_.notify_all();
+        response = R"({"status":"subscribed"})";
+        return 200;
+    }
+    
+    if (!request.contains("message") || !request["message"].is_string()) {
+        response = R"({"error":"bad request"})";
+        return 400;
+    }
+    published_++;
+    Publish(topic, request["message"].get<std::string>());
+    response = R"({"status":"published"})";
+    return 200;
+}
+
+} // namespace fake
+} // namespace optimum_p2p
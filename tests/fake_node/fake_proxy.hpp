@@ -0,0 +1,101 @@
+#pragma once
+
+#include "fake_node.hpp"
+#include "proxy_stream.grpc.pb.h"
+#include <grpcpp/grpcpp.h>
+#include <atomic>
+#include <list>
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace optimum_p2p {
+namespace fake {
+
+// FakeProxy is an in-process Optimum Proxy for tests and benchmarks: a
+// ProxyStream gRPC service plus a minimal HTTP/1.1 stub of the REST API
+// (POST /api/v1/subscribe and /api/v1/publish). Published messages are sent
+// to every connected client subscribed to the topic, with the latency, jitter
+// and fan-out of FakeNodeOptions.
+class FakeProxy : public proto::ProxyStream::Service {
+public:
+    explicit FakeProxy(FakeNodeOptions options = FakeNodeOptions());
+    ~FakeProxy() override;
+    
+    // Start the gRPC server on grpc_address ("127.0.0.1:0" picks a free port)
+    // and the REST stub on a free loopback port
+    bool Start(const std::string& grpc_address = "127.0.0.1:0");
+    void Stop();
+    
+    const std::string& GrpcAddress() const { return grpc_address_; }
+    const std::string& RestUrl() const { return rest_url_; } // http://127.0.0.1:<port>
+    
+    // Deliver payload to the topic's clients as if published through the proxy
+    void Inject(const std::string& topic, const std::string& payload);
+    
+    // Wait until count clients are subscribed to topic and have their stream open
+    bool WaitForClients(const std::string& topic, size_t count, std::chrono::milliseconds timeout);
+    
+    uint64_t Published() const { return published_.load(); }     // REST publish requests
+    uint64_t Delivered() const { return delivered_.load(); }     // stream messages written
+    uint64_t Connections() const { return accepted_.load(); } // REST connections accepted
+    
+    grpc::Status ClientStream(grpc::ServerContext* context,
+                              grpc::ServerReaderWriter<proto::ProxyMessage, proto::ProxyMessage>* stream) override;
+
+private:
+    struct Session {
+        grpc::ServerReaderWriter<proto::ProxyMessage, proto::ProxyMessage>* stream;
+        std::mutex write_mutex;
+        bool closed = false; // guarded by write_mutex
+    };
+    
+    // One thread per REST connection; finished ones are joined by AcceptLoop
+    struct Connection {
+        int fd;
+        std::thread thread;
+        bool done = false; // guarded by connections_mutex_
+    };
+    
+    void Publish(const std::string& topic, const std::string& payload);
+    void Deliver(std::shared_ptr<const proto::ProxyMessage> message);
+    size_t ConnectedClients(const std::string& topic) const; // mutex_ held
+    
+    // REST stub
+    void AcceptLoop();
+    void ServeConnection(Connection& connection);
+    int HandleRequest(const std::string& method, const std::string& path, const std::string& body,
+                      std::string& response);
+    
+    FakeNodeOptions options_;
+    std::string grpc_address_;
+    std::string rest_url_;
+    std::unique_ptr<grpc::Server> server_;
+    DeliveryScheduler scheduler_;
+    
+    mutable std::mutex mutex_;
+    std::condition_variable changed_;
+    std::map<std::string, std::shared_ptr<Session>> sessions_;   // by client_id
+    std::map<std::string, std::set<std::string>> subscriptions_; // topic -> client_ids
+    std::mt19937 rng_;                                           // guarded by mutex_
+    
+    std::atomic<uint64_t> next_message_id_;
+    std::atomic<uint64_t> published_;
+    std::atomic<uint64_t> delivered_;
+    std::atomic<uint64_t> accepted_;
+    
+    int listen_fd_;
+    std::atomic<bool> running_;
+    std::thread accept_thread_;
+    std::mutex connections_mutex_;
+    std::list<std::unique_ptr<Connection>> connections_;
+};
+
+} // namespace fake
+} // namespace optimum_p2p
@@ -81,6 +81,9 @@ TEST_F(MultiClientIntegrationTest, DISABLED_MultiPublishWithOutput) {
     std::vector<uint8_t> test_data = {'T', 'e', 's', 't'};
     client.PublishAll(test_topic_, test_data, 2, std::chrono::milliseconds(100));
     
+    // Lines are written by a background writer
+    client.Flush();
+    
     // Verify output file was created and contains expected data
     // Format: sender\tsize\tsha256(msg)
     if (fs::exists(output_file)) {
@@ -104,7 +107,7 @@ TEST_F(MultiClientIntegrationTest, DISABLED_MultiSubscribe) {
     
     // Set up callbacks
     std::atomic<int> message_count{0};
-    client.SetDataCallback([&](const std::string& addr, const P2PMessage& msg) {
+    client.SetDataCallback([&](const std::string& /*addr*/, const P2PMessage& /*msg*/) {
         message_count++;
     });
     
@@ -115,6 +118,24 @@ TEST_F(MultiClientIntegrationTest, DISABLED_MultiSubscribe) {
     SUCCEED();
 }
 
+// Test: Multi-subscribe with all node streams on a shared poller pool
+TEST_F(MultiClientIntegrationTest, DISABLED_MultiSubscribeAsyncEngine) {
+    auto ips = ReadIPsFromFile(ip_file_.string());
+    auto engine = std::make_shared<AsyncEngine>(2);
+    MultiSubscribeClient client(ips, engine);
+    
+    std::atomic<int> message_count{0};
+    client.SetDataCallback([&](const std::string& /*addr*/, const P2PMessage& /*msg*/) {
+        message_count++;
+    });
+    
+    client.SubscribeAll(test_topic_);
+    
+    std::this_thread::sleep_for(std::chrono::seconds(2));
+    
+    EXPECT_EQ(engine->NumThreads(), 2);
+}
+
 // Test: Multi-subscribe with data output file
 TEST_F(MultiClientIntegrationTest, DISABLED_MultiSubscribeWithDataOutput) {
     auto ips = ReadIPsFromFile(ip_file_.string());
@@ -127,6 +148,7 @@ TEST_F(MultiClientIntegrationTest, DISABLED_MultiSubscribeWithDataOutput) {
     
     // Wait for messages
     std::this_thread::sleep_for(std::chrono::seconds(2));
+    client.Flush();
     
     // Verify data file format: receiver\tsender\tsize\tsha256(msg)
     if (fs::exists(data_file)) {
@@ -155,6 +177,8 @@ TEST_F(MultiClientIntegrationTest, DISABLED_MultiSubscribeWithTraceOutput) {
     // Wait for trace events
     std::this_thread::sleep_for(std::chrono::seconds(2));
     
+    client.Flush();
+    
     // Verify trace file was created
     // Trace format: type\tpeerID\treceivedFrom\tmessageID\ttopic\ttimestamp
     if (fs::exists(trace_file)) {
@@ -162,6 +186,7 @@ TEST_F(MultiClientIntegrationTest, DISABLED_MultiSubscribeWithTraceOutput) {
         std::string line;
         int line_count = 0;
         while (std::getline(file, line)) {
+            EXPECT_EQ(std::count(line.begin(), line.end(), '\t'), 5) << line;
             line_count++;
         }
         // Trace file may be empty if no trace events occurred
@@ -169,6 +194,54 @@ TEST_F(MultiClientIntegrationTest, DISABLED_MultiSubscribeWithTraceOutput) {
     }
 }
 
+// Test: Trace sampling rate 0 keeps trace sinks quiet while messages flow
+TEST_F(MultiClientIntegrationTest, DISABLED_MultiSubscribeTraceSampling) {
+    auto ips = ReadIPsFromFile(ip_file_.string());
+    MultiSubscribeClient client(ips);
+    
+    std::atomic<int> trace_lines{0};
+    std::atomic<int> messages{0};
+    client.SetTraceCallback([&trace_lines](const std::string&) { trace_lines++; });
+    client.SetDataCallback([&messages](const std::string&, const P2PMessage&) { messages++; });
+    client.SetTraceSampleRate(0.0);
+    
+    client.SubscribeAll(test_topic_);
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    
+    MultiPublishClient publisher({ips[0]});
+    std::vector<uint8_t> test_data = {'T', 'r', 'a', 'c', 'e'};
+    publisher.PublishAll(test_topic_, test_data, 10, std::chrono::milliseconds(10));
+    
+    std::this_thread::sleep_for(std::chrono::seconds(2));
+    
+    EXPECT_EQ(trace_lines.load(), 0);
+}
+
+// Test: End-to-end latency from the publish timestamp prefix
+TEST_F(MultiClientIntegrationTest, DISABLED_MultiSubscribeLatency) {
+    auto ips = ReadIPsFromFile(ip_file_.string());
+    MultiSubscribeClient client(ips);
+    
+    auto tracker = std::make_shared<LatencyTracker>();
+    client.SetLatencyTracker(tracker);
+    client.SubscribeAll(test_topic_);
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    
+    MultiPublishClient publisher({ips[0]});
+    std::vector<uint8_t> test_data = {'L', 'a', 't'};
+    publisher.PublishAll(test_topic_, test_data, 10, std::chrono::milliseconds(10));
+    
+    std::this_thread::sleep_for(std::chrono::seconds(2));
+    
+    // Every received message carries the prefix
+    EXPECT_EQ(tracker->MissingPrefix(), 0u);
+    HistogramSnapshot total = tracker->GetTotal();
+    if (total.Count() > 0) {
+        EXPECT_GT(total.Percentile(99), 0u);
+        EXPECT_FALSE(tracker->GetSnapshot().empty());
+    }
+}
+
 // Test: IP range selection
 TEST_F(MultiClientIntegrationTest, IPRangeSelection) {
     auto all_ips = ReadIPsFromFile(ip_file_.string());
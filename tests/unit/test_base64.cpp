@@ -0,0 +1,184 @@
+#include <gtest/gtest.h>
+#include "optimum_p2p/base64.hpp"
+#include <vector>
+#include <string>
+#include <random>
+
+namespace optimum_p2p {
+
+class Base64Test : public ::testing::Test {
+protected:
+    void SetUp() override {}
+    void TearDown() override {}
+    
+    // Reference encoder for round-trip tests
+    static std::string Encode(const std::vector<uint8_t>& data) {
+        static const char* chars = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+        std::string out;
+        size_t i = 0;
+        for (; i + 3 <= data.size(); i += 3) {
+            uint32_t n = (data[i] << 16) | (data[i + 1] << 8) | data[i + 2];
+            out += chars[(n >> 18) & 63];
+            out += chars[(n >> 12) & 63];
+            out += chars[(n >> 6) & 63];
+            out += chars[n & 63];
+        }
+        if (data.size() - i == 1) {
+            uint32_t n = data[i] << 16;
+            out += chars[(n >> 18) & 63];
+            out += chars[(n >> 12) & 63];
+            out += "==";
+        } else if (data.size() - i == 2) {
+            uint32_t n = (data[i] << 16) | (data[i + 1] << 8);
+            out += chars[(n >> 18) & 63];
+            out += chars[(n >> 12) & 63];
+            out += chars[(n >> 6) & 63];
+            out += '=';
+        }
+        return out;
+    }
+    
+    static std::string Decode(const std::string& input, bool strict, Base64Kernel kernel,
+                              Base64Result* result_out = nullptr) {
+        std::vector<uint8_t> out(Base64DecodedMaxSize(input.size()));
+        Base64Result result = Base64Decode(input, out.data(), strict, kernel);
+        if (result_out) {
+            *result_out = result;
+        }
+        return std::string(out.begin(), out.begin() + result.written);
+    }
+    
+    static const std::vector<Base64Kernel>& Kernels() {
+        static const std::vector<Base64Kernel> kernels = {
+            Base64Kernel::Scalar, Base64Kernel::SSE41, Base64Kernel::AVX2, Base64Kernel::Auto
+        };
+        return kernels;
+    }
+};
+
+// Test RFC 4648 vectors
+TEST_F(Base64Test, KnownVectors) {
+    std::vector<std::pair<std::string, std::string>> cases = {
+        {"", ""}, {"Zg==", "f"}, {"Zm8=", "fo"}, {"Zm9v", "foo"},
+        {"Zm9vYg==", "foob"}, {"Zm9vYmE=", "fooba"}, {"Zm9vYmFy", "foobar"}
+    };
+    
+    for (const auto& [encoded, decoded] : cases) {
+        EXPECT_EQ(Decode(encoded, true, Base64Kernel::Auto), decoded);
+        EXPECT_EQ(Decode(encoded, false, Base64Kernel::Auto), decoded);
+    }
+}
+
+// Test round trip across kernels and lengths around the SIMD block sizes
+TEST_F(Base64Test, RoundTripAllKernels) {
+    std::mt19937 rng(42);
+    
+    for (size_t len = 0; len < 200; len++) {
+        std::vector<uint8_t> data(len);
+        for (auto& b : data) {
+            b = static_cast<uint8_t>(rng());
+        }
+        std::string encoded = Encode(data);
+        std::string expected(data.begin(), data.end());
+        
+        for (Base64Kernel kernel : Kernels()) {
+            Base64Result result;
+            EXPECT_EQ(Decode(encoded, true, kernel, &result), expected) << "len=" << len;
+            EXPECT_EQ(result.status, Base64Status::Ok);
+            EXPECT_EQ(Decode(encoded, false, kernel), expected) << "len=" << len;
+        }
+    }
+}
+
+// Test that every kernel agrees with the scalar decoder on corrupted input
+TEST_F(Base64Test, KernelsMatchScalarOnInvalidInput) {
+    std::mt19937 rng(7);
+    const char noise[] = {' ', '\n', '=', '-', '_', '\0', '\x80', '\xff', '.'};
+    
+    for (int iter = 0; iter < 2000; iter++) {
+        std::vector<uint8_t> data(rng() % 300);
+        for (auto& b : data) {
+            b = static_cast<uint8_t>(rng());
+        }
+        std::string encoded = Encode(data);
+        if (!encoded.empty()) {
+            encoded[rng() % encoded.size()] = noise[rng() % sizeof(noise)];
+        }
+        
+        Base64Result strict_ref;
+        std::string lenient_ref = Decode(encoded, false, Base64Kernel::Scalar);
+        std::string strict_out = Decode(encoded, true, Base64Kernel::Scalar, &strict_ref);
+        
+        for (Base64Kernel kernel : Kernels()) {
+            Base64Result result;
+            EXPECT_EQ(Decode(encoded, false, kernel), lenient_ref);
+            EXPECT_EQ(Decode(encoded, true, kernel, &result), strict_out);
+            EXPECT_EQ(result.status, strict_ref.status);
+            EXPECT_EQ(result.error_offset, strict_ref.error_offset);
+        }
+    }
+}
+
+// Test lenient mode keeps the historical behaviour
+TEST_F(Base64Test, LenientSkipsInvalidAndStopsAtPadding) {
+    EXPECT_EQ(Decode("Zm9v\nYmFy", false, Base64Kernel::Auto), "foobar");
+    EXPECT_EQ(Decode("Zm9v YmFy", false, Base64Kernel::Auto), "foobar");
+    EXPECT_EQ(Decode("Zg==Zm9v", false, Base64Kernel::Auto), "f");
+    EXPECT_EQ(Decode("Zm9vY", false, Base64Kernel::Auto), "foo");
+}
+
+// Test strict mode error reporting
+TEST_F(Base64Test, StrictErrors) {
+    Base64Result result;
+    
+    Decode("Zm9vY", true, Base64Kernel::Auto, &result);
+    EXPECT_EQ(result.status, Base64Status::InvalidLength);
+    
+    Decode("Zm9v Ym=", true, Base64Kernel::Auto, &result);
+    EXPECT_EQ(result.status, Base64Status::InvalidCharacter);
+    EXPECT_EQ(result.error_offset, 4u);
+    
+    Decode("Zg==Zm9v", true, Base64Kernel::Auto, &result);
+    EXPECT_EQ(result.status, Base64Status::InvalidPadding);
+    EXPECT_EQ(result.error_offset, 2u);
+    
+    Decode("Z===", true, Base64Kernel::Auto, &result);
+    EXPECT_EQ(result.status, Base64Status::InvalidPadding);
+    EXPECT_EQ(result.error_offset, 1u);
+    
+    Decode("Zm=v", true, Base64Kernel::Auto, &result);
+    EXPECT_EQ(result.status, Base64Status::InvalidPadding);
+    EXPECT_EQ(result.error_offset, 2u);
+    
+    // Non-zero bits under the padding never come from a canonical encoder
+    Decode("QR==", true, Base64Kernel::Auto, &result);
+    EXPECT_EQ(result.status, Base64Status::NonCanonical);
+    EXPECT_EQ(result.error_offset, 1u);
+    
+    Decode("Zm9vQUJ=", true, Base64Kernel::Auto, &result);
+    EXPECT_EQ(result.status, Base64Status::NonCanonical);
+    EXPECT_EQ(result.error_offset, 6u);
+    
+    EXPECT_EQ(Decode("QQ==", true, Base64Kernel::Auto, &result), "A");
+    EXPECT_EQ(Decode("QUI=", true, Base64Kernel::Auto, &result), "AB");
+    EXPECT_EQ(result.status, Base64Status::Ok);
+}
+
+// Test the vector overload sizes its output
+TEST_F(Base64Test, VectorOverload) {
+    std::vector<uint8_t> out = {1, 2, 3, 4, 5, 6, 7, 8, 9};
+    EXPECT_EQ(Base64Decode("Zm9vYg==", out, true), Base64Status::Ok);
+    EXPECT_EQ(std::string(out.begin(), out.end()), "foob");
+    
+    EXPECT_EQ(Base64Decode("", out), Base64Status::Ok);
+    EXPECT_TRUE(out.empty());
+}
+
+// Test kernel names and detection
+TEST_F(Base64Test, ActiveKernel) {
+    Base64Kernel kernel = Base64ActiveKernel();
+    EXPECT_NE(kernel, Base64Kernel::Auto);
+    EXPECT_STRNE(Base64KernelName(kernel), "unknown");
+}
+
+} // namespace optimum_p2p
@@ -0,0 +1,183 @@
+#include <gtest/gtest.h>
+#include "optimum_p2p/bounded_queue.hpp"
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace optimum_p2p {
+
+class BoundedQueueTest : public ::testing::Test {
+protected:
+    void SetUp() override {}
+    void TearDown() override {}
+};
+
+// Test FIFO order and TryPush backpressure
+TEST_F(BoundedQueueTest, TryPushFailsWhenFull) {
+    BoundedQueue<int> queue(2);
+    
+    EXPECT_TRUE(queue.TryPush(1));
+    EXPECT_TRUE(queue.TryPush(2));
+    EXPECT_FALSE(queue.TryPush(3));
+    EXPECT_EQ(queue.Size(), 2u);
+    
+    int value = 0;
+    ASSERT_TRUE(queue.Pop(value));
+    EXPECT_EQ(value, 1);
+    EXPECT_TRUE(queue.TryPush(3));
+    ASSERT_TRUE(queue.Pop(value));
+    EXPECT_EQ(value, 2);
+    ASSERT_TRUE(queue.Pop(value));
+    EXPECT_EQ(value, 3);
+}
+
+// Test a failed push leaves the item untouched
+TEST_F(BoundedQueueTest, FailedPushKeepsItem) {
+    BoundedQueue<std::unique_ptr<int>> queue(1);
+    
+    auto first = std::make_unique<int>(1);
+    auto second = std::make_unique<int>(2);
+    EXPECT_TRUE(queue.TryPush(std::move(first)));
+    EXPECT_FALSE(queue.TryPush(std::move(second)));
+    ASSERT_NE(second, nullptr);
+    EXPECT_EQ(*second, 2);
+}
+
+// Test Push blocks until a consumer makes room
+TEST_F(BoundedQueueTest, PushBlocksWhileFull) {
+    BoundedQueue<int> queue(1);
+    ASSERT_TRUE(queue.Push(1));
+    
+    std::atomic<bool> pushed{false};
+    std::thread producer([&]() {
+        queue.Push(2);
+        pushed = true;
+    });
+    
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_FALSE(pushed);
+    
+    int value = 0;
+    ASSERT_TRUE(queue.Pop(value));
+    producer.join();
+    EXPECT_TRUE(pushed);
+}
+
+// Test Close wakes blocked callers and lets consumers drain
+TEST_F(BoundedQueueTest, CloseDrainsThenFails) {
+    BoundedQueue<int> queue(4);
+    queue.Push(1);
+    queue.Push(2);
+    queue.Close();
+    
+    EXPECT_FALSE(queue.Push(3));
+    EXPECT_FALSE(queue.TryPush(3));
+    
+    int value = 0;
+    EXPECT_TRUE(queue.Pop(value));
+    EXPECT_TRUE(queue.Pop(value));
+    EXPECT_EQ(value, 2);
+    EXPECT_FALSE(queue.Pop(value));
+}
+
+// Test PushDropOldest evicts from the front and never blocks
+TEST_F(BoundedQueueTest, PushDropOldestEvicts) {
+    BoundedQueue<int> queue(2);
+    size_t dropped = 0;
+    
+    EXPECT_TRUE(queue.PushDropOldest(1, dropped));
+    EXPECT_EQ(dropped, 0u);
+    EXPECT_TRUE(queue.PushDropOldest(2, dropped));
+    EXPECT_TRUE(queue.PushDropOldest(3, dropped));
+    EXPECT_EQ(dropped, 1u);
+    EXPECT_EQ(queue.Size(), 2u);
+    
+    int value = 0;
+    ASSERT_TRUE(queue.Pop(value));
+    EXPECT_EQ(value, 2);
+    ASSERT_TRUE(queue.Pop(value));
+    EXPECT_EQ(value, 3);
+    
+    queue.Close();
+    EXPECT_FALSE(queue.PushDropOldest(4, dropped));
+}
+
+// Test PopFor times out on an empty queue and wakes up for a push
+TEST_F(BoundedQueueTest, PopForTimesOut) {
+    BoundedQueue<int> queue(4);
+    int value = 0;
+    
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_FALSE(queue.PopFor(value, std::chrono::milliseconds(50)));
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(50));
+    
+    // Zero timeout polls
+    EXPECT_FALSE(queue.PopFor(value, std::chrono::milliseconds(0)));
+    
+    std::thread producer([&]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        queue.Push(7);
+    });
+    EXPECT_TRUE(queue.PopFor(value, std::chrono::seconds(5)));
+    EXPECT_EQ(value, 7);
+    producer.join();
+}
+
+// Test PopBatch takes what is available, up to max, in order
+TEST_F(BoundedQueueTest, PopBatchTakesUpToMax) {
+    BoundedQueue<int> queue(8);
+    for (int i = 1; i <= 5; i++) {
+        queue.Push(int(i));
+    }
+    
+    std::vector<int> out;
+    EXPECT_EQ(queue.PopBatch(out, 3, std::chrono::milliseconds(0)), 3u);
+    EXPECT_EQ(queue.PopBatch(out, 10, std::chrono::milliseconds(0)), 2u);
+    EXPECT_EQ(out, (std::vector<int>{1, 2, 3, 4, 5}));
+    
+    EXPECT_EQ(queue.PopBatch(out, 10, std::chrono::milliseconds(20)), 0u);
+    
+    // A closed queue still hands out what is left
+    queue.Push(6);
+    queue.Close();
+    EXPECT_EQ(queue.PopBatch(out, 10, std::chrono::seconds(5)), 1u);
+    EXPECT_EQ(queue.PopBatch(out, 10, std::chrono::seconds(5)), 0u);
+}
+
+// Test many producers and consumers
+TEST_F(BoundedQueueTest, ConcurrentProducersConsumers) {
+    BoundedQueue<int> queue(8);
+    std::atomic<long> sum{0};
+    
+    std::vector<std::thread> consumers;
+    for (int c = 0; c < 3; c++) {
+        consumers.emplace_back([&]() {
+            int value;
+            while (queue.Pop(value)) {
+                sum += value;
+            }
+        });
+    }
+    
+    std::vector<std::thread> producers;
+    for (int p = 0; p < 4; p++) {
+        producers.emplace_back([&]() {
+            for (int i = 1; i <= 1000; i++) {
+                queue.Push(int(i));
+            }
+        });
+    }
+    for (auto& t : producers) {
+        t.join();
+    }
+    queue.Close();
+    for (auto& t : consumers) {
+        t.join();
+    }
+    
+    EXPECT_EQ(sum, 4 * 500500L);
+}
+
+} // namespace optimum_p2p
@@ -0,0 +1,114 @@
+#include <gtest/gtest.h>
+#include "optimum_p2p/dispatch_pool.hpp"
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace optimum_p2p {
+
+class DispatchPoolTest : public ::testing::Test {
+protected:
+    void SetUp() override {}
+    void TearDown() override {}
+};
+
+// Test jobs with the same key run in submission order
+TEST_F(DispatchPoolTest, SameKeyRunsInOrder) {
+    DispatchPool pool(4);
+    
+    const int keys = 8;
+    const int per_key = 500;
+    std::mutex mutex;
+    std::vector<std::vector<int>> seen(keys);
+    
+    for (int i = 0; i < per_key; i++) {
+        for (int k = 0; k < keys; k++) {
+            ASSERT_TRUE(pool.Submit(k, [&, k, i]() {
+                std::lock_guard<std::mutex> lock(mutex);
+                seen[k].push_back(i);
+            }));
+        }
+    }
+    pool.Shutdown();
+    
+    for (int k = 0; k < keys; k++) {
+        ASSERT_EQ(seen[k].size(), static_cast<size_t>(per_key));
+        for (int i = 0; i < per_key; i++) {
+            EXPECT_EQ(seen[k][i], i);
+        }
+    }
+}
+
+// Test a slow job does not hold up other keys
+TEST_F(DispatchPoolTest, KeysRunInParallel) {
+    DispatchPool pool(2);
+    
+    std::atomic<bool> release{false};
+    std::atomic<bool> other_ran{false};
+    
+    pool.Submit(0, [&]() {
+        while (!release) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    });
+    pool.Submit(1, [&]() { other_ran = true; });
+    
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!other_ran && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_TRUE(other_ran);
+    
+    release = true;
+}
+
+// Test Shutdown runs queued jobs and later submits fail
+TEST_F(DispatchPoolTest, ShutdownDrainsQueue) {
+    DispatchPool pool(1, 16);
+    std::atomic<int> ran{0};
+    
+    for (int i = 0; i < 16; i++) {
+        pool.Submit(0, [&]() {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            ran++;
+        });
+    }
+    pool.Shutdown();
+    
+    EXPECT_EQ(ran, 16);
+    EXPECT_FALSE(pool.Submit(0, [&]() { ran++; }));
+    EXPECT_EQ(ran, 16);
+}
+
+// Test Submit blocks while the worker's queue is full
+TEST_F(DispatchPoolTest, SubmitBlocksWhenFull) {
+    DispatchPool pool(1, 1);
+    
+    std::atomic<bool> release{false};
+    pool.Submit(0, [&]() {
+        while (!release) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    });
+    
+    // Wait for the worker to take the first job so the queue is empty again
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    pool.Submit(0, []() {});
+    
+    std::atomic<bool> submitted{false};
+    std::thread producer([&]() {
+        pool.Submit(0, []() {});
+        submitted = true;
+    });
+    
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_FALSE(submitted);
+    
+    release = true;
+    producer.join();
+    EXPECT_TRUE(submitted);
+}
+
+} // namespace optimum_p2p
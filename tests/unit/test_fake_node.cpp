@@ -0,0 +1,688 @@
+#include <gtest/gtest.h>
+#include "fake_node.hpp"
+#include "fake_proxy.hpp"
+#include "optimum_p2p/client.hpp"
+#include "optimum_p2p/latency_tracker.hpp"
+#include "optimum_p2p/multi_client.hpp"
+#include "optimum_p2p/proxy_client.hpp"
+#include <grpcpp/grpcpp.h>
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace optimum_p2p {
+
+class FakeNodeTest : public ::testing::Test {
+protected:
+    void SetUp() override {}
+    void TearDown() override {}
+    
+    // Collects messages delivered to a callback
+    struct Inbox {
+        std::mutex mutex;
+        std::condition_variable cv;
+        std::vector<P2PMessage> messages;
+        
+        void Add(const P2PMessage& message) {
+            std::lock_guard<std::mutex> lock(mutex);
+            messages.push_back(message);
+            cv.notify_all();
+        }
+        
+        bool WaitFor(size_t count, std::chrono::milliseconds timeout = std::chrono::seconds(5)) {
+            std::unique_lock<std::mutex> lock(mutex);
+            return cv.wait_for(lock, timeout, [&]() { return messages.size() >= count; });
+        }
+    };
+};
+
+// Test a publish is delivered to subscribers in the node's envelope
+TEST_F(FakeNodeTest, PublishReachesSubscriber) {
+    fake::FakeNodeOptions options;
+    options.node_id = "node-a";
+    fake::FakeNode node(options);
+    ASSERT_TRUE(node.Start());
+    
+    Inbox inbox;
+    P2PClient subscriber(node.Address());
+    subscriber.SetMessageCallback([&](const P2PMessage& message) { inbox.Add(message); });
+    ASSERT_TRUE(subscriber.Subscribe("topic"));
+    ASSERT_TRUE(node.WaitForSubscribers("topic", 1, std::chrono::seconds(5)));
+    
+    P2PClient publisher(node.Address());
+    std::vector<uint8_t> payload = {'h', 'e', 'l', 'l', 'o', 0, 0xff};
+    ASSERT_TRUE(publisher.Publish("topic", payload));
+    ASSERT_TRUE(publisher.Publish("other", payload));
+    
+    ASSERT_TRUE(inbox.WaitFor(1));
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    std::lock_guard<std::mutex> lock(inbox.mutex);
+    ASSERT_EQ(inbox.messages.size(), 1u);
+    EXPECT_EQ(inbox.messages[0].topic, "topic");
+    EXPECT_EQ(inbox.messages[0].message, payload);
+    EXPECT_EQ(inbox.messages[0].source_node_id, "node-a");
+    EXPECT_EQ(inbox.messages[0].message_id, "node-a-1");
+    EXPECT_EQ(node.Published(), 2u);
+    EXPECT_EQ(node.Delivered(), 1u);
+    
+    publisher.Shutdown();
+    subscriber.Shutdown();
+}
+
+// Test envelopes that fail to decode are counted and not delivered
+TEST_F(FakeNodeTest, UndecodableMessagesAreSkipped) {
+    fake::FakeNodeOptions options;
+    options.base64_payloads = false;
+    fake::FakeNode node(options);
+    ASSERT_TRUE(node.Start());
+    
+    Inbox inbox;
+    P2PClient subscriber(node.Address());
+    subscriber.SetPayloadEncoding(PayloadEncoding::Base64);
+    subscriber.SetMessageCallback([&](const P2PMessage& message) { inbox.Add(message); });
+    ASSERT_TRUE(subscriber.Subscribe("topic"));
+    
+    // Without a callback nothing reaches the receive queue either
+    P2PClient queued(node.Address());
+    queued.SetPayloadEncoding(PayloadEncoding::Base64);
+    ASSERT_TRUE(queued.Subscribe("topic"));
+    ASSERT_TRUE(node.WaitForSubscribers("topic", 2, std::chrono::seconds(5)));
+    
+    node.Inject("topic", "not base64!");
+    node.Inject("topic", "aGk=");
+    ASSERT_TRUE(inbox.WaitFor(1));
+    
+    P2PMessage message;
+    ASSERT_TRUE(queued.ReceiveMessage(message, std::chrono::seconds(5)));
+    EXPECT_EQ(std::string(message.message.begin(), message.message.end()), "hi");
+    EXPECT_FALSE(queued.ReceiveMessage(message, std::chrono::milliseconds(50)));
+    EXPECT_EQ(queued.GetDecodeFailures(), 1u);
+    
+    std::lock_guard<std::mutex> lock(inbox.mutex);
+    ASSERT_EQ(inbox.messages.size(), 1u);
+    EXPECT_EQ(std::string(inbox.messages[0].message.begin(), inbox.messages[0].message.end()), "hi");
+    EXPECT_EQ(subscriber.GetDecodeFailures(), 1u);
+    
+    queued.Shutdown();
+    subscriber.Shutdown();
+}
+
+// Test messages arriving before the first ReceiveMessage are kept, the
+// oldest making room, so a subscriber that never drains does not stall
+TEST_F(FakeNodeTest, ReceiveQueueKeepsEarlyMessages) {
+    fake::FakeNodeOptions options;
+    options.gossipsub_traces = true;
+    fake::FakeNode node(options);
+    ASSERT_TRUE(node.Start());
+    
+    // Each delivery is followed by a trace, so traces show what has been read
+    std::atomic<int> traces{0};
+    P2PClient subscriber(node.Address());
+    subscriber.SetTraceCallback([&](ResponseType, std::string_view) { traces++; });
+    ASSERT_TRUE(subscriber.Subscribe("topic"));
+    ASSERT_TRUE(node.WaitForSubscribers("topic", 1, std::chrono::seconds(5)));
+    
+    // More than the default depth of 1024 with the default Block policy
+    for (int i = 0; i < 1500; i++) {
+        node.Inject("topic", std::to_string(i));
+    }
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (traces < 1500 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    ASSERT_EQ(traces, 1500);
+    
+    ReceiveQueueStats stats = subscriber.GetReceiveQueueStats();
+    EXPECT_EQ(stats.queued, 1500u);
+    EXPECT_EQ(stats.dropped_oldest, 476u);
+    EXPECT_EQ(stats.depth, 1024u);
+    
+    std::vector<P2PMessage> messages;
+    ASSERT_EQ(subscriber.ReceiveBatch(messages, 2000, std::chrono::milliseconds(0)), 1024u);
+    EXPECT_EQ(std::string(messages.front().message.begin(), messages.front().message.end()), "476");
+    EXPECT_EQ(std::string(messages.back().message.begin(), messages.back().message.end()), "1499");
+    
+    // Once read, the queue applies its Block policy
+    subscriber.SetReceiveQueueDepth(1);
+    node.Inject("topic", "late");
+    node.Inject("topic", "later");
+    P2PMessage message;
+    ASSERT_TRUE(subscriber.ReceiveMessage(message, std::chrono::seconds(5)));
+    EXPECT_EQ(std::string(message.message.begin(), message.message.end()), "late");
+    ASSERT_TRUE(subscriber.ReceiveMessage(message, std::chrono::seconds(5)));
+    EXPECT_EQ(std::string(message.message.begin(), message.message.end()), "later");
+    EXPECT_EQ(subscriber.GetReceiveQueueStats().dropped_oldest, 476u);
+    
+    subscriber.Shutdown();
+}
+
+// Test async-mode clients drop the oldest queued message instead of
+// blocking the poller shared with other clients
+TEST_F(FakeNodeTest, AsyncReceiveQueueDoesNotStallEngine) {
+    fake::FakeNode node;
+    ASSERT_TRUE(node.Start());
+    auto engine = std::make_shared<AsyncEngine>(1);
+    
+    P2PClient idle(node.Address(), engine);
+    idle.SetReceiveQueueDepth(4);
+    ASSERT_TRUE(idle.Subscribe("topic"));
+    
+    Inbox inbox;
+    P2PClient active(node.Address(), engine);
+    active.SetMessageCallback([&](const P2PMessage& message) { inbox.Add(message); });
+    ASSERT_TRUE(active.Subscribe("topic"));
+    ASSERT_TRUE(node.WaitForSubscribers("topic", 2, std::chrono::seconds(5)));
+    
+    for (int i = 0; i < 100; i++) {
+        node.Inject("topic", std::to_string(i));
+    }
+    ASSERT_TRUE(inbox.WaitFor(100));
+    
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (idle.GetReceiveQueueStats().queued < 100 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    ReceiveQueueStats stats = idle.GetReceiveQueueStats();
+    EXPECT_EQ(stats.queued, 100u);
+    EXPECT_EQ(stats.dropped_oldest, 96u);
+    EXPECT_EQ(stats.depth, 4u);
+    
+    active.Shutdown();
+    idle.Shutdown();
+}
+
+// Test publishes racing Shutdown resolve and leave no writer thread behind
+TEST_F(FakeNodeTest, PublishAsyncRacingShutdown) {
+    fake::FakeNode node;
+    ASSERT_TRUE(node.Start());
+    std::vector<uint8_t> payload(64, 'x');
+    
+    for (int round = 0; round < 20; round++) {
+        P2PClient client(node.Address());
+        
+        std::vector<std::thread> publishers;
+        for (int t = 0; t < 4; t++) {
+            publishers.emplace_back([&]() {
+                for (int i = 0; i < 50; i++) {
+                    client.PublishAsync("topic", payload).get();
+                }
+            });
+        }
+        client.Shutdown();
+        for (auto& publisher : publishers) {
+            publisher.join();
+        }
+    }
+}
+
+// Test direct publishes racing concurrent Shutdown calls: one caller shuts
+// down and no write follows the stream's half-close
+TEST_F(FakeNodeTest, PublishRacingConcurrentShutdown) {
+    fake::FakeNode node;
+    ASSERT_TRUE(node.Start());
+    std::vector<uint8_t> payload(64, 'x');
+    
+    for (int round = 0; round < 20; round++) {
+        P2PClient client(node.Address());
+        
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 2; t++) {
+            threads.emplace_back([&]() {
+                for (int i = 0; i < 50; i++) {
+                    client.Publish("topic", payload);
+                }
+            });
+            threads.emplace_back([&]() { client.Shutdown(); });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        EXPECT_FALSE(client.Publish("topic", payload));
+    }
+}
+
+// Test publish and receive with both clients driven by an AsyncEngine
+TEST_F(FakeNodeTest, AsyncEnginePublishAndReceive) {
+    fake::FakeNode node;
+    ASSERT_TRUE(node.Start());
+    auto engine = std::make_shared<AsyncEngine>(2);
+    
+    Inbox inbox;
+    P2PClient subscriber(node.Address(), engine);
+    subscriber.SetMessageCallback([&](const P2PMessage& message) { inbox.Add(message); });
+    ASSERT_TRUE(subscriber.Subscribe("topic"));
+    ASSERT_TRUE(node.WaitForSubscribers("topic", 1, std::chrono::seconds(5)));
+    
+    P2PClient publisher(node.Address(), engine);
+    for (int i = 0; i < 200; i++) {
+        std::string text = std::to_string(i);
+        ASSERT_TRUE(publisher.Publish("topic", std::vector<uint8_t>(text.begin(), text.end())));
+    }
+    
+    ASSERT_TRUE(inbox.WaitFor(200));
+    EXPECT_EQ(node.Published(), 200u);
+    {
+        std::lock_guard<std::mutex> lock(inbox.mutex);
+        ASSERT_EQ(inbox.messages.size(), 200u);
+        for (int i = 0; i < 200; i++) {
+            EXPECT_EQ(std::string(inbox.messages[i].message.begin(), inbox.messages[i].message.end()),
+                      std::to_string(i));
+        }
+    }
+    
+    publisher.Shutdown();
+    subscriber.Shutdown();
+    
+    // Shut down clients fail further calls
+    EXPECT_FALSE(publisher.Publish("topic", {'x'}));
+}
+
+// Test concurrent PublishAsync callers, blocking and async mode: every
+// future succeeds and each caller's messages arrive in its order
+TEST_F(FakeNodeTest, ConcurrentPublishAsync) {
+    fake::FakeNode node;
+    ASSERT_TRUE(node.Start());
+    auto engine = std::make_shared<AsyncEngine>(2);
+    const int threads = 4;
+    const int per_thread = 250;
+    
+    for (bool async_mode : {false, true}) {
+        SCOPED_TRACE(async_mode ? "async mode" : "blocking mode");
+        std::string topic = async_mode ? "async" : "blocking";
+        
+        Inbox inbox;
+        P2PClient subscriber(node.Address());
+        subscriber.SetMessageCallback([&](const P2PMessage& message) { inbox.Add(message); });
+        ASSERT_TRUE(subscriber.Subscribe(topic));
+        ASSERT_TRUE(node.WaitForSubscribers(topic, 1, std::chrono::seconds(5)));
+        
+        auto publisher = async_mode ? std::make_unique<P2PClient>(node.Address(), engine)
+                                    : std::make_unique<P2PClient>(node.Address());
+        publisher->SetSendQueueDepth(16);
+        
+        std::atomic<int> failures{0};
+        std::vector<std::thread> workers;
+        for (int t = 0; t < threads; t++) {
+            workers.emplace_back([&, t]() {
+                std::vector<std::future<bool>> results;
+                for (int i = 0; i < per_thread; i++) {
+                    std::string text = std::to_string(t) + ":" + std::to_string(i);
+                    results.push_back(publisher->PublishAsync(topic, std::vector<uint8_t>(text.begin(), text.end())));
+                }
+                for (auto& result : results) {
+                    if (!result.get()) {
+                        failures++;
+                    }
+                }
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        EXPECT_EQ(failures, 0);
+        
+        ASSERT_TRUE(inbox.WaitFor(threads * per_thread));
+        std::vector<int> next(threads, 0);
+        {
+            std::lock_guard<std::mutex> lock(inbox.mutex);
+            EXPECT_EQ(inbox.messages.size(), static_cast<size_t>(threads * per_thread));
+            for (const auto& message : inbox.messages) {
+                std::string text(message.message.begin(), message.message.end());
+                int t = std::stoi(text.substr(0, text.find(':')));
+                int i = std::stoi(text.substr(text.find(':') + 1));
+                EXPECT_EQ(i, next[t]++);
+            }
+        }
+        
+        publisher->Shutdown();
+        subscriber.Shutdown();
+    }
+}
+
+// Test TryPublishAsync refuses to queue past the send queue depth, and what
+// it accepts is delivered
+TEST_F(FakeNodeTest, TryPublishAsyncBackpressure) {
+    fake::FakeNode node;
+    ASSERT_TRUE(node.Start());
+    auto engine = std::make_shared<AsyncEngine>(1);
+    
+    // Large enough that a write is still in progress while the next ones are tried
+    std::vector<uint8_t> payload(4 << 20, 'x');
+    
+    for (bool async_mode : {false, true}) {
+        SCOPED_TRACE(async_mode ? "async mode" : "blocking mode");
+        std::string topic = async_mode ? "async" : "blocking";
+        
+        Inbox inbox;
+        P2PClient subscriber(node.Address());
+        subscriber.SetMessageCallback([&](const P2PMessage& message) { inbox.Add(message); });
+        ASSERT_TRUE(subscriber.Subscribe(topic));
+        ASSERT_TRUE(node.WaitForSubscribers(topic, 1, std::chrono::seconds(5)));
+        
+        auto publisher = async_mode ? std::make_unique<P2PClient>(node.Address(), engine)
+                                    : std::make_unique<P2PClient>(node.Address());
+        publisher->SetSendQueueDepth(1);
+        
+        std::vector<std::future<bool>> accepted;
+        int rejected = 0;
+        for (int i = 0; i < 20; i++) {
+            std::future<bool> result;
+            if (publisher->TryPublishAsync(topic, payload, result)) {
+                accepted.push_back(std::move(result));
+            } else {
+                rejected++;
+            }
+        }
+        EXPECT_GT(rejected, 0);
+        EXPECT_FALSE(accepted.empty());
+        for (auto& result : accepted) {
+            EXPECT_TRUE(result.get());
+        }
+        
+        ASSERT_TRUE(inbox.WaitFor(accepted.size(), std::chrono::seconds(10)));
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        {
+            std::lock_guard<std::mutex> lock(inbox.mutex);
+            EXPECT_EQ(inbox.messages.size(), accepted.size());
+        }
+        
+        publisher->Shutdown();
+        subscriber.Shutdown();
+    }
+}
+
+// Test PublishBatch through direct writes, the send queue and async mode:
+// every message succeeds and the batch arrives in order
+TEST_F(FakeNodeTest, PublishBatch) {
+    fake::FakeNode node;
+    ASSERT_TRUE(node.Start());
+    auto engine = std::make_shared<AsyncEngine>(1);
+    
+    Inbox inbox;
+    P2PClient subscriber(node.Address());
+    subscriber.SetMessageCallback([&](const P2PMessage& message) { inbox.Add(message); });
+    ASSERT_TRUE(subscriber.Subscribe("topic"));
+    ASSERT_TRUE(node.WaitForSubscribers("topic", 1, std::chrono::seconds(5)));
+    
+    P2PClient direct(node.Address());
+    P2PClient queued(node.Address());
+    P2PClient async(node.Address(), engine);
+    // A PublishAsync starts the writer thread, after which batches are queued
+    ASSERT_TRUE(queued.PublishAsync("warmup", {'w'}).get());
+    
+    size_t expected = 0;
+    for (P2PClient* publisher : {&direct, &queued, &async}) {
+        std::vector<std::vector<uint8_t>> payloads;
+        for (int i = 0; i < 100; i++) {
+            std::string text = std::to_string(expected + i);
+            payloads.emplace_back(text.begin(), text.end());
+        }
+        
+        std::vector<bool> results = publisher->PublishBatch("topic", payloads);
+        ASSERT_EQ(results.size(), payloads.size());
+        EXPECT_EQ(std::count(results.begin(), results.end(), true), 100);
+        expected += payloads.size();
+        ASSERT_TRUE(inbox.WaitFor(expected));
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(inbox.mutex);
+        ASSERT_EQ(inbox.messages.size(), expected);
+        for (size_t i = 0; i < expected; i++) {
+            EXPECT_EQ(std::string(inbox.messages[i].message.begin(), inbox.messages[i].message.end()),
+                      std::to_string(i));
+        }
+    }
+    
+    // An empty batch writes nothing, a shut down client fails every message
+    EXPECT_TRUE(direct.PublishBatch("topic", {}).empty());
+    direct.Shutdown();
+    EXPECT_EQ(direct.PublishBatch("topic", {{'a'}, {'b'}}), std::vector<bool>({false, false}));
+    
+    async.Shutdown();
+    queued.Shutdown();
+    subscriber.Shutdown();
+}
+
+// Test callbacks dispatched to a DispatchPool keep per-topic order, in
+// blocking and async mode
+TEST_F(FakeNodeTest, DispatchPoolKeepsPerTopicOrder) {
+    fake::FakeNode node;
+    ASSERT_TRUE(node.Start());
+    auto engine = std::make_shared<AsyncEngine>(1);
+    auto pool = std::make_shared<DispatchPool>(4);
+    const std::vector<std::string> topics = {"a", "b", "c", "d"};
+    const int per_topic = 200;
+    
+    for (bool async_mode : {false, true}) {
+        SCOPED_TRACE(async_mode ? "async mode" : "blocking mode");
+        
+        std::mutex mutex;
+        std::condition_variable cv;
+        std::map<std::string, std::vector<int>> received;
+        size_t total = 0;
+        
+        auto subscriber = async_mode ? std::make_unique<P2PClient>(node.Address(), engine)
+                                     : std::make_unique<P2PClient>(node.Address());
+        subscriber->SetDispatchPool(pool, DispatchOrder::PerTopic);
+        subscriber->SetMessageCallback([&](const P2PMessage& message) {
+            // Uneven work so workers would reorder anything not kept in order
+            if (message.message.back() % 3 == 0) {
+                std::this_thread::sleep_for(std::chrono::microseconds(50));
+            }
+            std::lock_guard<std::mutex> lock(mutex);
+            received[message.topic].push_back(std::stoi(std::string(message.message.begin(), message.message.end())));
+            total++;
+            cv.notify_all();
+        });
+        for (const auto& topic : topics) {
+            ASSERT_TRUE(subscriber->Subscribe(topic));
+        }
+        ASSERT_TRUE(node.WaitForSubscribers(topics.back(), 1, std::chrono::seconds(5)));
+        
+        for (int i = 0; i < per_topic; i++) {
+            for (const auto& topic : topics) {
+                node.Inject(topic, std::to_string(i));
+            }
+        }
+        
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            ASSERT_TRUE(cv.wait_for(lock, std::chrono::seconds(10), [&]() {
+                return total == topics.size() * per_topic;
+            }));
+            for (const auto& topic : topics) {
+                const auto& sequence = received[topic];
+                ASSERT_EQ(sequence.size(), static_cast<size_t>(per_topic)) << topic;
+                for (int i = 0; i < per_topic; i++) {
+                    EXPECT_EQ(sequence[i], i) << topic;
+                }
+            }
+        }
+        
+        subscriber->Shutdown();
+    }
+}
+
+// Test Health and ListTopics
+TEST_F(FakeNodeTest, HealthAndListTopics) {
+    fake::FakeNodeOptions options;
+    options.node_mode = "relay";
+    fake::FakeNode node(options);
+    ASSERT_TRUE(node.Start());
+    
+    P2PClient subscriber(node.Address());
+    ASSERT_TRUE(subscriber.Subscribe("a"));
+    ASSERT_TRUE(subscriber.Subscribe("b"));
+    ASSERT_TRUE(node.WaitForSubscribers("b", 1, std::chrono::seconds(5)));
+    
+    auto stub = proto::CommandStream::NewStub(
+        grpc::CreateChannel(node.Address(), grpc::InsecureChannelCredentials()));
+    
+    grpc::ClientContext health_context;
+    proto::HealthResponse health;
+    ASSERT_TRUE(stub->Health(&health_context, proto::Void(), &health).ok());
+    EXPECT_TRUE(health.status());
+    EXPECT_EQ(health.nodemode(), "relay");
+    EXPECT_EQ(health.p2paddress(), node.Address());
+    
+    grpc::ClientContext topics_context;
+    proto::TopicList topics;
+    ASSERT_TRUE(stub->ListTopics(&topics_context, proto::Void(), &topics).ok());
+    ASSERT_EQ(topics.topics_size(), 2);
+    EXPECT_EQ(topics.topics(0), "a");
+    EXPECT_EQ(topics.topics(1), "b");
+    
+    subscriber.Shutdown();
+}
+
+// Test each subscriber gets fan_out copies of a message
+TEST_F(FakeNodeTest, FanOut) {
+    fake::FakeNodeOptions options;
+    options.fan_out = 3;
+    fake::FakeNode node(options);
+    ASSERT_TRUE(node.Start());
+    
+    Inbox inbox;
+    P2PClient subscriber(node.Address());
+    subscriber.SetMessageCallback([&](const P2PMessage& message) { inbox.Add(message); });
+    ASSERT_TRUE(subscriber.Subscribe("topic"));
+    ASSERT_TRUE(node.WaitForSubscribers("topic", 1, std::chrono::seconds(5)));
+    
+    node.Inject("topic", "payload");
+    ASSERT_TRUE(inbox.WaitFor(3));
+    EXPECT_EQ(node.Delivered(), 3u);
+    
+    std::lock_guard<std::mutex> lock(inbox.mutex);
+    EXPECT_EQ(inbox.messages[0].message_id, inbox.messages[2].message_id);
+    
+    subscriber.Shutdown();
+}
+
+// Test deliveries wait for the configured latency
+TEST_F(FakeNodeTest, LatencyInjection) {
+    fake::FakeNodeOptions options;
+    options.latency = std::chrono::milliseconds(100);
+    options.jitter = std::chrono::milliseconds(10);
+    fake::FakeNode node(options);
+    ASSERT_TRUE(node.Start());
+    
+    Inbox inbox;
+    P2PClient subscriber(node.Address());
+    subscriber.SetMessageCallback([&](const P2PMessage& message) { inbox.Add(message); });
+    ASSERT_TRUE(subscriber.Subscribe("topic"));
+    ASSERT_TRUE(node.WaitForSubscribers("topic", 1, std::chrono::seconds(5)));
+    
+    auto start = std::chrono::steady_clock::now();
+    node.Inject("topic", "late");
+    EXPECT_FALSE(inbox.WaitFor(1, std::chrono::milliseconds(50)));
+    ASSERT_TRUE(inbox.WaitFor(1));
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(100));
+    
+    subscriber.Shutdown();
+}
+
+// Test the generator's rate, sizes and latency prefix through MultiSubscribeClient
+TEST_F(FakeNodeTest, GeneratorDrivesMultiSubscribeClient) {
+    fake::FakeNode first;
+    fake::FakeNode second;
+    ASSERT_TRUE(first.Start());
+    ASSERT_TRUE(second.Start());
+    
+    std::mutex mutex;
+    size_t received = 0;
+    size_t min_size = SIZE_MAX;
+    size_t max_size = 0;
+    auto tracker = std::make_shared<LatencyTracker>();
+    
+    MultiSubscribeClient client({first.Address(), second.Address()});
+    client.SetLatencyTracker(tracker);
+    client.SetDataCallback([&](const std::string&, const P2PMessage& message) {
+        std::lock_guard<std::mutex> lock(mutex);
+        received++;
+        min_size = std::min(min_size, message.message.size());
+        max_size = std::max(max_size, message.message.size());
+    });
+    client.SubscribeAll("gen");
+    ASSERT_TRUE(first.WaitForSubscribers("gen", 1, std::chrono::seconds(5)));
+    ASSERT_TRUE(second.WaitForSubscribers("gen", 1, std::chrono::seconds(5)));
+    
+    first.StartGenerator("gen", 2000, fake::PayloadSizes::Uniform(100, 200));
+    second.StartGenerator("gen", 2000, fake::PayloadSizes::Weighted({{64, 1}, {512, 1}}));
+    std::this_thread::sleep_for(std::chrono::milliseconds(250));
+    first.StopGenerator();
+    second.StopGenerator();
+    
+    // About rate * 0.25s each, allowing for a slow machine
+    uint64_t generated = first.Generated() + second.Generated();
+    EXPECT_GT(generated, 500u);
+    EXPECT_LT(generated, 1200u);
+    
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (std::chrono::steady_clock::now() < deadline) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (received >= generated) {
+                break;
+            }
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        EXPECT_EQ(received, generated);
+        // Sizes exclude the "[<nanos> <size>] " prefix
+        EXPECT_GT(min_size, 64u);
+        EXPECT_LE(max_size, 512u + 40u);
+    }
+    EXPECT_EQ(tracker->GetTotal().Count(), generated);
+    EXPECT_EQ(tracker->MissingPrefix(), 0u);
+}
+
+// Test ProxyClient against the fake proxy's REST stub and stream
+TEST_F(FakeNodeTest, ProxyPublishSubscribe) {
+    fake::FakeNodeOptions options;
+    options.fan_out = 2;
+    fake::FakeProxy proxy(options);
+    ASSERT_TRUE(proxy.Start());
+    
+    ProxyClient client(proxy.RestUrl(), proxy.GrpcAddress());
+    ASSERT_TRUE(client.Subscribe("client_1", "topic"));
+    ASSERT_TRUE(client.ConnectStream("client_1"));
+    ASSERT_TRUE(proxy.WaitForClients("topic", 1, std::chrono::seconds(5)));
+    
+    // Large enough for curl to ask for 100-continue
+    std::string large(4096, 'z');
+    ASSERT_TRUE(client.Publish("client_1", "topic", "hello"));
+    ASSERT_TRUE(client.Publish("client_1", "topic", large));
+    EXPECT_EQ(proxy.Published(), 2u);
+    
+    std::string topic;
+    std::string message;
+    ASSERT_TRUE(client.ReceiveMessage(topic, message));
+    EXPECT_EQ(topic, "topic");
+    EXPECT_EQ(message, "hello");
+    ASSERT_TRUE(client.ReceiveMessage(topic, message));
+    EXPECT_EQ(message, "hello");
+    // Every copy is read; ProxyClient's destructor waits for the stream to finish
+    for (int copy = 0; copy < 2; copy++) {
+        ASSERT_TRUE(client.ReceiveMessage(topic, message));
+        EXPECT_EQ(message, large);
+    }
+    EXPECT_EQ(proxy.Delivered(), 4u);
+    
+    // Unknown routes are rejected
+    ProxyClient wrong(proxy.RestUrl() + "/missing", proxy.GrpcAddress());
+    EXPECT_FALSE(wrong.Subscribe("client_1", "topic"));
+}
+
+} // namespace optimum_p2p
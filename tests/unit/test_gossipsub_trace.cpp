@@ -0,0 +1,199 @@
+#include <gtest/gtest.h>
+#include "optimum_p2p/gossipsub_trace.hpp"
+#include "optimum_p2p/utils.hpp"
+#include "trace.pb.h"
+#include <string>
+#include <vector>
+
+namespace optimum_p2p {
+
+using pubsub::pb::TraceEvent;
+
+class GossipSubTraceTest : public ::testing::Test {
+protected:
+    void SetUp() override {}
+    void TearDown() override {}
+    
+    static std::string Publish(const std::string& peer, const std::string& id, const std::string& topic, int64_t ts) {
+        TraceEvent event;
+        event.set_type(TraceEvent::PUBLISH_MESSAGE);
+        event.set_peerid(peer);
+        event.set_timestamp(ts);
+        event.mutable_publishmessage()->set_messageid(id);
+        event.mutable_publishmessage()->set_topic(topic);
+        return event.SerializeAsString();
+    }
+    
+    static std::string Deliver(const std::string& peer, const std::string& id, const std::string& topic,
+                               const std::string& from, int64_t ts) {
+        TraceEvent event;
+        event.set_type(TraceEvent::DELIVER_MESSAGE);
+        event.set_peerid(peer);
+        event.set_timestamp(ts);
+        event.mutable_delivermessage()->set_messageid(id);
+        event.mutable_delivermessage()->set_topic(topic);
+        event.mutable_delivermessage()->set_receivedfrom(from);
+        return event.SerializeAsString();
+    }
+    
+    static std::string Duplicate(const std::string& peer, const std::string& id, const std::string& topic, int64_t ts) {
+        TraceEvent event;
+        event.set_type(TraceEvent::DUPLICATE_MESSAGE);
+        event.set_peerid(peer);
+        event.set_timestamp(ts);
+        event.mutable_duplicatemessage()->set_messageid(id);
+        event.mutable_duplicatemessage()->set_topic(topic);
+        return event.SerializeAsString();
+    }
+    
+    static std::string Graft(const std::string& peer, const std::string& other, const std::string& topic, bool prune) {
+        TraceEvent event;
+        event.set_type(prune ? TraceEvent::PRUNE : TraceEvent::GRAFT);
+        event.set_peerid(peer);
+        if (prune) {
+            event.mutable_prune()->set_peerid(other);
+            event.mutable_prune()->set_topic(topic);
+        } else {
+            event.mutable_graft()->set_peerid(other);
+            event.mutable_graft()->set_topic(topic);
+        }
+        return event.SerializeAsString();
+    }
+};
+
+// Test latency is measured from the publish event
+TEST_F(GossipSubTraceTest, DeliveryLatencyFromPublish) {
+    GossipSubTraceAggregator aggregator;
+    
+    EXPECT_TRUE(aggregator.Add(Publish("A", "m1", "t", 1000)));
+    EXPECT_TRUE(aggregator.Add(Deliver("B", "m1", "t", "A", 1000 + 2000000)));
+    EXPECT_TRUE(aggregator.Add(Deliver("C", "m1", "t", "B", 1000 + 5000000)));
+    EXPECT_TRUE(aggregator.Add(Duplicate("C", "m1", "t", 1000 + 6000000)));
+    
+    GossipSubTopicStats stats;
+    ASSERT_TRUE(aggregator.GetTopicStats("t", stats));
+    EXPECT_EQ(stats.published, 1u);
+    EXPECT_EQ(stats.delivered, 2u);
+    EXPECT_EQ(stats.duplicates, 1u);
+    EXPECT_EQ(stats.delivery_latency.Count(), 2u);
+    EXPECT_EQ(stats.delivery_latency.Min(), 2000000u);
+    EXPECT_EQ(stats.delivery_latency.Max(), 5000000u);
+    
+    EXPECT_FALSE(aggregator.GetTopicStats("other", stats));
+}
+
+// Test without a traced publish the earliest sighting is the reference
+TEST_F(GossipSubTraceTest, DeliveryLatencyWithoutPublish) {
+    GossipSubTraceAggregator aggregator;
+    
+    aggregator.Add(Deliver("B", "m1", "t", "A", 5000));
+    aggregator.Add(Deliver("C", "m1", "t", "B", 8000));
+    
+    GossipSubTopicStats stats;
+    ASSERT_TRUE(aggregator.GetTopicStats("t", stats));
+    EXPECT_EQ(stats.delivery_latency.Min(), 0u);
+    EXPECT_EQ(stats.delivery_latency.Max(), 3000u);
+}
+
+// Test the first-seen table is bounded
+TEST_F(GossipSubTraceTest, TrackedMessagesBounded) {
+    GossipSubTraceAggregator aggregator(2);
+    
+    aggregator.Add(Publish("A", "m1", "t", 100));
+    aggregator.Add(Publish("A", "m2", "t", 200));
+    aggregator.Add(Publish("A", "m3", "t", 300)); // forgets m1
+    aggregator.Add(Deliver("B", "m1", "t", "A", 1000));
+    
+    GossipSubTopicStats stats;
+    ASSERT_TRUE(aggregator.GetTopicStats("t", stats));
+    EXPECT_EQ(stats.delivery_latency.Max(), 0u);
+}
+
+// Test mesh fan-out follows GRAFT and PRUNE
+TEST_F(GossipSubTraceTest, MeshFanOut) {
+    GossipSubTraceAggregator aggregator;
+    
+    aggregator.Add(Graft("A", "B", "t", false));
+    aggregator.Add(Graft("A", "C", "t", false));
+    aggregator.Add(Graft("B", "A", "t", false));
+    aggregator.Add(Graft("A", "B", "t", false)); // repeated graft
+    
+    auto stats = aggregator.GetTopicStats();
+    ASSERT_EQ(stats.count("t"), 1u);
+    EXPECT_EQ(stats["t"].mesh_nodes, 2u);
+    EXPECT_EQ(stats["t"].mesh_peers, 3u);
+    
+    aggregator.Add(Graft("B", "A", "t", true));
+    stats = aggregator.GetTopicStats();
+    EXPECT_EQ(stats["t"].mesh_nodes, 1u);
+    EXPECT_EQ(stats["t"].mesh_peers, 2u);
+}
+
+// Test forwarded counts come from SEND_RPC message metadata
+TEST_F(GossipSubTraceTest, ForwardedFromSendRPC) {
+    GossipSubTraceAggregator aggregator;
+    
+    TraceEvent event;
+    event.set_type(TraceEvent::SEND_RPC);
+    event.set_peerid("A");
+    auto* meta = event.mutable_sendrpc()->mutable_meta();
+    meta->add_messages()->set_topic("t1");
+    meta->add_messages()->set_topic("t1");
+    meta->add_messages()->set_topic("t2");
+    ASSERT_TRUE(aggregator.Add(event.SerializeAsString()));
+    
+    auto stats = aggregator.GetTopicStats();
+    EXPECT_EQ(stats["t1"].forwarded, 2u);
+    EXPECT_EQ(stats["t2"].forwarded, 1u);
+}
+
+// Test totals, decode errors and Reset
+TEST_F(GossipSubTraceTest, TotalsAndDecodeErrors) {
+    GossipSubTraceAggregator aggregator;
+    
+    aggregator.Add(Publish("A", "m1", "t", 1));
+    aggregator.Add(Deliver("B", "m1", "t", "A", 2));
+    aggregator.Add(Deliver("C", "m1", "t", "A", 3));
+    
+    std::vector<uint8_t> garbage = {0xff, 0xff, 0xff};
+    EXPECT_FALSE(aggregator.Add(garbage.data(), garbage.size()));
+    EXPECT_FALSE(aggregator.Add(std::string_view())); // no type
+    
+    GossipSubTraceTotals totals = aggregator.GetTotals();
+    EXPECT_EQ(totals.events, 3u);
+    EXPECT_EQ(totals.decode_errors, 2u);
+    EXPECT_EQ(totals.events_by_type["PUBLISH_MESSAGE"], 1u);
+    EXPECT_EQ(totals.events_by_type["DELIVER_MESSAGE"], 2u);
+    
+    aggregator.Reset();
+    EXPECT_EQ(aggregator.GetTotals().events, 0u);
+    EXPECT_TRUE(aggregator.GetTopicStats().empty());
+}
+
+// Test the trace file line format
+TEST_F(GossipSubTraceTest, TraceLine) {
+    std::string peer("\x00\x01", 2);
+    std::string event = Deliver(peer, "\xab\xcd", "t", std::string(1, '\x00'), 42);
+    
+    std::vector<std::string> lines;
+    auto callback = [&lines](const std::string& line) { lines.push_back(line); };
+    
+    HandleGossipSubTrace(std::string_view(event), true, callback);
+    ASSERT_EQ(lines.size(), 1u);
+    EXPECT_EQ(lines[0], "DELIVER_MESSAGE\t12\t1\tabcd\tt\t42");
+    
+    // Summary line
+    HandleGossipSubTrace(std::vector<uint8_t>(event.begin(), event.end()), false, callback);
+    ASSERT_EQ(lines.size(), 2u);
+    EXPECT_EQ(lines[1].rfind("[GossipSub Trace] DELIVER_MESSAGE", 0), 0u);
+    
+    // Undecodable events are not written to the trace file
+    std::vector<uint8_t> garbage = {0xff, 0xff};
+    HandleGossipSubTrace(garbage, true, callback);
+    EXPECT_EQ(lines.size(), 2u);
+    HandleGossipSubTrace(garbage, false, callback);
+    ASSERT_EQ(lines.size(), 3u);
+    EXPECT_NE(lines[2].find("ffff"), std::string::npos);
+}
+
+} // namespace optimum_p2p
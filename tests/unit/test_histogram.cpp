@@ -0,0 +1,111 @@
+#include <gtest/gtest.h>
+#include "optimum_p2p/histogram.hpp"
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace optimum_p2p {
+
+class HistogramTest : public ::testing::Test {
+protected:
+    void SetUp() override {}
+    void TearDown() override {}
+};
+
+// Test every value maps to a bucket that contains it, within ~3%
+TEST_F(HistogramTest, BucketsCoverValues) {
+    std::vector<uint64_t> values = {0, 1, 31, 32, 33, 63, 64, 65, 1000, 123456789,
+                                    uint64_t(1) << 40, UINT64_MAX};
+    
+    for (uint64_t value : values) {
+        size_t index = HistogramSnapshot::BucketIndex(value);
+        ASSERT_LT(index, HistogramSnapshot::kNumBuckets);
+        EXPECT_LE(HistogramSnapshot::BucketLow(index), value);
+        EXPECT_GE(HistogramSnapshot::BucketHigh(index), value);
+        
+        double width = double(HistogramSnapshot::BucketHigh(index) - HistogramSnapshot::BucketLow(index));
+        EXPECT_LE(width, double(value) * 0.032);
+    }
+    
+    // Small values are exact
+    EXPECT_EQ(HistogramSnapshot::BucketIndex(31), 31u);
+    EXPECT_EQ(HistogramSnapshot::BucketIndex(UINT64_MAX), HistogramSnapshot::kNumBuckets - 1);
+}
+
+// Test percentiles, min, max and mean
+TEST_F(HistogramTest, Percentiles) {
+    LatencyHistogram histogram;
+    for (uint64_t i = 1; i <= 1000; i++) {
+        histogram.Record(i * 1000);
+    }
+    
+    HistogramSnapshot snapshot = histogram.Snapshot();
+    EXPECT_EQ(snapshot.Count(), 1000u);
+    EXPECT_EQ(snapshot.Min(), 1000u);
+    EXPECT_EQ(snapshot.Max(), 1000000u);
+    EXPECT_DOUBLE_EQ(snapshot.Mean(), 500500.0);
+    
+    EXPECT_NEAR(double(snapshot.Percentile(50)), 500000.0, 500000.0 * 0.032);
+    EXPECT_NEAR(double(snapshot.Percentile(99)), 990000.0, 990000.0 * 0.032);
+    EXPECT_EQ(snapshot.Percentile(0), 1000u);
+    EXPECT_EQ(snapshot.Percentile(100), 1000000u);
+}
+
+// Test an empty histogram reports zeros
+TEST_F(HistogramTest, EmptySnapshot) {
+    LatencyHistogram histogram;
+    HistogramSnapshot snapshot = histogram.Snapshot();
+    
+    EXPECT_EQ(snapshot.Count(), 0u);
+    EXPECT_EQ(snapshot.Min(), 0u);
+    EXPECT_EQ(snapshot.Max(), 0u);
+    EXPECT_EQ(snapshot.Percentile(50), 0u);
+    EXPECT_EQ(snapshot.Mean(), 0.0);
+}
+
+// Test Merge and Reset
+TEST_F(HistogramTest, MergeAndReset) {
+    LatencyHistogram a;
+    LatencyHistogram b;
+    a.Record(10);
+    a.Record(20);
+    b.Record(5);
+    b.Record(1000);
+    
+    HistogramSnapshot merged = a.Snapshot();
+    merged.Merge(b.Snapshot());
+    EXPECT_EQ(merged.Count(), 4u);
+    EXPECT_EQ(merged.Min(), 5u);
+    EXPECT_EQ(merged.Max(), 1000u);
+    
+    // Merging an empty snapshot keeps the minimum
+    merged.Merge(HistogramSnapshot());
+    EXPECT_EQ(merged.Min(), 5u);
+    
+    a.Reset();
+    EXPECT_EQ(a.Snapshot().Count(), 0u);
+}
+
+// Test concurrent recording loses nothing
+TEST_F(HistogramTest, ConcurrentRecord) {
+    LatencyHistogram histogram;
+    
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([&histogram, t]() {
+            for (uint64_t i = 0; i < 10000; i++) {
+                histogram.Record(i + t);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    
+    HistogramSnapshot snapshot = histogram.Snapshot();
+    EXPECT_EQ(snapshot.Count(), 40000u);
+    EXPECT_EQ(snapshot.Min(), 0u);
+    EXPECT_EQ(snapshot.Max(), 10002u);
+}
+
+} // namespace optimum_p2p
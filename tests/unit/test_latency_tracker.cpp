@@ -0,0 +1,159 @@
+#include <gtest/gtest.h>
+#include "optimum_p2p/latency_tracker.hpp"
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace optimum_p2p {
+
+class LatencyTrackerTest : public ::testing::Test {
+protected:
+    void SetUp() override {}
+    void TearDown() override {}
+};
+
+// Test the publish prefix is parsed in place
+TEST_F(LatencyTrackerTest, ParsePublishPrefix) {
+    int64_t nanos = 0;
+    size_t size = 0;
+    
+    EXPECT_TRUE(ParsePublishPrefix("[1700000000123456789 5] hello", nanos, size));
+    EXPECT_EQ(nanos, 1700000000123456789);
+    EXPECT_EQ(size, 5u);
+    
+    EXPECT_FALSE(ParsePublishPrefix("hello", nanos, size));
+    EXPECT_FALSE(ParsePublishPrefix("[abc 5] hello", nanos, size));
+    EXPECT_FALSE(ParsePublishPrefix("[123 5 hello", nanos, size));
+    EXPECT_FALSE(ParsePublishPrefix("[123] hello", nanos, size));
+    EXPECT_FALSE(ParsePublishPrefix("[123 ", nanos, size));
+    EXPECT_FALSE(ParsePublishPrefix("", nanos, size));
+}
+
+// Test latencies are kept per (source, receiver) pair
+TEST_F(LatencyTrackerTest, RecordPerPair) {
+    LatencyTracker tracker;
+    
+    EXPECT_TRUE(tracker.Record("node-a", "127.0.0.1:1", "[1000 1] x", 3000));
+    EXPECT_TRUE(tracker.Record("node-a", "127.0.0.1:1", "[1000 1] x", 5000));
+    EXPECT_TRUE(tracker.Record("node-b", "127.0.0.1:1", "[1000 1] x", 11000));
+    EXPECT_FALSE(tracker.Record("node-b", "127.0.0.1:1", "no prefix", 11000));
+    EXPECT_EQ(tracker.MissingPrefix(), 1u);
+    
+    HistogramSnapshot pair;
+    ASSERT_TRUE(tracker.GetPairSnapshot("node-a", "127.0.0.1:1", pair));
+    EXPECT_EQ(pair.Count(), 2u);
+    EXPECT_EQ(pair.Min(), 2000u);
+    EXPECT_EQ(pair.Max(), 4000u);
+    EXPECT_FALSE(tracker.GetPairSnapshot("node-c", "127.0.0.1:1", pair));
+    
+    auto snapshot = tracker.GetSnapshot();
+    ASSERT_EQ(snapshot.size(), 2u);
+    EXPECT_EQ(snapshot[0].source, "node-a");
+    EXPECT_EQ(snapshot[1].source, "node-b");
+    EXPECT_EQ(snapshot[1].latency.Max(), 10000u);
+    
+    HistogramSnapshot total = tracker.GetTotal();
+    EXPECT_EQ(total.Count(), 3u);
+    EXPECT_EQ(total.Max(), 10000u);
+}
+
+// Test pairs past max_pairs are merged per receiver
+TEST_F(LatencyTrackerTest, MaxPairs) {
+    LatencyTracker tracker(2);
+    
+    tracker.RecordLatency("node-a", "r1", 1000);
+    tracker.RecordLatency("node-b", "r1", 2000);
+    tracker.RecordLatency("node-c", "r1", 3000); // over the cap
+    tracker.RecordLatency("node-d", "r1", 4000);
+    tracker.RecordLatency("node-c", "r2", 5000);
+    tracker.RecordLatency("node-a", "r1", 6000); // existing pairs still record
+    EXPECT_EQ(tracker.MergedRecords(), 3u);
+    
+    HistogramSnapshot pair;
+    EXPECT_FALSE(tracker.GetPairSnapshot("node-c", "r1", pair));
+    ASSERT_TRUE(tracker.GetPairSnapshot("node-a", "r1", pair));
+    EXPECT_EQ(pair.Count(), 2u);
+    ASSERT_TRUE(tracker.GetPairSnapshot("*", "r1", pair));
+    EXPECT_EQ(pair.Count(), 2u);
+    EXPECT_EQ(pair.Min(), 3000u);
+    
+    auto snapshot = tracker.GetSnapshot();
+    ASSERT_EQ(snapshot.size(), 4u);
+    EXPECT_EQ(snapshot[0].source, "*");
+    EXPECT_EQ(snapshot[1].receiver, "r2");
+    EXPECT_EQ(tracker.GetTotal().Count(), 6u);
+    
+    // Only per-receiver pairs
+    LatencyTracker per_receiver(0);
+    per_receiver.RecordLatency("node-a", "r1", 1000);
+    per_receiver.RecordLatency("node-b", "r1", 2000);
+    snapshot = per_receiver.GetSnapshot();
+    ASSERT_EQ(snapshot.size(), 1u);
+    EXPECT_EQ(snapshot[0].source, "*");
+    EXPECT_EQ(snapshot[0].latency.Count(), 2u);
+}
+
+// Test negative latencies count as clock skew
+TEST_F(LatencyTrackerTest, ClockSkew) {
+    LatencyTracker tracker;
+    
+    tracker.Record("a", "b", "[5000 1] x", 1000);
+    EXPECT_EQ(tracker.ClockSkew(), 1u);
+    EXPECT_EQ(tracker.GetTotal().Max(), 0u);
+    
+    tracker.Reset();
+    EXPECT_EQ(tracker.ClockSkew(), 0u);
+    EXPECT_EQ(tracker.GetTotal().Count(), 0u);
+}
+
+// Test the summary has a header, a line per pair and a total
+TEST_F(LatencyTrackerTest, Summary) {
+    LatencyTracker tracker;
+    tracker.RecordLatency("a", "r1", 1000);
+    tracker.RecordLatency("b", "r1", 2000);
+    
+    std::string summary = tracker.Summary();
+    EXPECT_EQ(summary.rfind("source\treceiver\tcount", 0), 0u);
+    EXPECT_NE(summary.find("a\tr1\t1\t1.0\t1.0\t1.0\t1.0\n"), std::string::npos);
+    EXPECT_NE(summary.find("*\t*\t2\t"), std::string::npos);
+}
+
+// Test the periodic dump runs until stopped
+TEST_F(LatencyTrackerTest, PeriodicSummary) {
+    LatencyTracker tracker;
+    std::atomic<int> dumps{0};
+    
+    tracker.StartPeriodicSummary(std::chrono::milliseconds(10), [&dumps](const std::string&) { dumps++; });
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    tracker.StopPeriodicSummary();
+    
+    int seen = dumps.load();
+    EXPECT_GE(seen, 2);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_EQ(dumps.load(), seen);
+}
+
+// Test concurrent recording from many receiving threads
+TEST_F(LatencyTrackerTest, ConcurrentRecord) {
+    LatencyTracker tracker;
+    
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([&tracker, t]() {
+            std::string receiver = "r" + std::to_string(t);
+            for (int i = 0; i < 5000; i++) {
+                tracker.RecordLatency(i % 2 ? "a" : "b", receiver, i);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    
+    EXPECT_EQ(tracker.GetSnapshot().size(), 8u);
+    EXPECT_EQ(tracker.GetTotal().Count(), 20000u);
+}
+
+} // namespace optimum_p2p
@@ -0,0 +1,216 @@
+#include <gtest/gtest.h>
+#include "fake_node.hpp"
+#include "optimum_p2p/client.hpp"
+#include "optimum_p2p/latency_tracker.hpp"
+#include "optimum_p2p/load_generator.hpp"
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace optimum_p2p {
+
+class LoadGeneratorTest : public ::testing::Test {
+protected:
+    void SetUp() override {}
+    void TearDown() override {}
+    
+    static double Seconds(std::chrono::nanoseconds offset) {
+        return std::chrono::duration<double>(offset).count();
+    }
+};
+
+// Test constant arrivals are evenly spaced from the start of the run
+TEST_F(LoadGeneratorTest, ConstantScheduleIsEven) {
+    LoadProfile profile;
+    profile.rate = 1000;
+    LoadSchedule schedule(profile, 1);
+    
+    EXPECT_EQ(schedule.Next().count(), 0);
+    for (int i = 1; i <= 10000; i++) {
+        EXPECT_NEAR(Seconds(schedule.Next()), i / 1000.0, 1e-9);
+    }
+    EXPECT_DOUBLE_EQ(schedule.MessagesBy(2.5), 2500);
+}
+
+// Test a ramp sends the messages its average rate implies, then holds the rate
+TEST_F(LoadGeneratorTest, RampSchedule) {
+    LoadProfile profile;
+    profile.start_rate = 0;
+    profile.rate = 1000;
+    profile.ramp = std::chrono::seconds(2);
+    LoadSchedule schedule(profile, 1);
+    
+    // 0 -> 1000/s over 2s averages 500/s: 1000 messages
+    EXPECT_DOUBLE_EQ(schedule.MessagesBy(1), 250);
+    EXPECT_DOUBLE_EQ(schedule.MessagesBy(2), 1000);
+    EXPECT_DOUBLE_EQ(schedule.MessagesBy(3), 2000);
+    
+    int during_ramp = 0;
+    double previous = 0;
+    double offset = 0;
+    while ((offset = Seconds(schedule.Next())) < 2.0) {
+        EXPECT_GE(offset, previous);
+        previous = offset;
+        during_ramp++;
+    }
+    EXPECT_EQ(during_ramp, 1000);
+    
+    // The 250th message is due after 1s (250 = 1000 * t^2 / 4)
+    LoadSchedule again(profile, 1);
+    for (int i = 0; i < 250; i++) {
+        again.Next();
+    }
+    EXPECT_NEAR(Seconds(again.Next()), 1.0, 1e-6);
+}
+
+// Test a ramp down to zero ends the schedule
+TEST_F(LoadGeneratorTest, RampDownEnds) {
+    LoadProfile profile;
+    profile.start_rate = 100;
+    profile.rate = 0;
+    profile.ramp = std::chrono::seconds(1);
+    LoadSchedule schedule(profile, 1);
+    
+    int sent = 0;
+    while (schedule.Next() != std::chrono::nanoseconds::max()) {
+        ASSERT_LT(++sent, 1000);
+    }
+    EXPECT_EQ(sent, 50);
+}
+
+// Test Poisson arrivals average the target rate with exponential gaps
+TEST_F(LoadGeneratorTest, PoissonSchedule) {
+    LoadProfile profile;
+    profile.rate = 1000;
+    profile.arrivals = ArrivalProcess::Poisson;
+    LoadSchedule schedule(profile, 42);
+    
+    int count = 0;
+    int short_gaps = 0;
+    double previous = 0;
+    double offset = 0;
+    while ((offset = Seconds(schedule.Next())) < 10.0) {
+        // P(gap < mean / 2) = 1 - e^-0.5 for exponential gaps
+        if (offset - previous < 0.0005) {
+            short_gaps++;
+        }
+        previous = offset;
+        count++;
+    }
+    EXPECT_NEAR(count, 10000, 400);
+    EXPECT_NEAR(short_gaps / double(count), 0.3935, 0.02);
+    
+    // Same seed, same schedule
+    LoadSchedule first(profile, 7);
+    LoadSchedule second(profile, 7);
+    for (int i = 0; i < 100; i++) {
+        EXPECT_EQ(first.Next(), second.Next());
+    }
+}
+
+// Test Start rejects profiles without a positive rate
+TEST_F(LoadGeneratorTest, StartRejectsZeroRate) {
+    LoadGenerator generator({"127.0.0.1:1"});
+    LoadProfile profile;
+    profile.rate = 0;
+    EXPECT_FALSE(generator.Start("topic", profile));
+    EXPECT_FALSE(generator.Running());
+    EXPECT_TRUE(generator.GetStats().empty());
+}
+
+// Test a run against two fake nodes reaches the target rate
+TEST_F(LoadGeneratorTest, PublishesAtTargetRate) {
+    fake::FakeNode first;
+    fake::FakeNode second;
+    ASSERT_TRUE(first.Start());
+    ASSERT_TRUE(second.Start());
+    
+    // Subscribers check the timestamp prefix
+    auto tracker = std::make_shared<LatencyTracker>();
+    std::atomic<int> received{0};
+    P2PClient subscriber(first.Address());
+    subscriber.SetMessageViewCallback([&](const P2PMessageView& message) {
+        tracker->Record(message.source_node_id, "first", message.message,
+                        std::chrono::duration_cast<std::chrono::nanoseconds>(
+                            std::chrono::system_clock::now().time_since_epoch()).count());
+        received++;
+    });
+    ASSERT_TRUE(subscriber.Subscribe("load"));
+    ASSERT_TRUE(first.WaitForSubscribers("load", 1, std::chrono::seconds(5)));
+    
+    LoadProfile profile;
+    profile.rate = 500;
+    profile.duration = std::chrono::milliseconds(500);
+    profile.payload_size = 64;
+    
+    LoadGenerator generator({first.Address(), second.Address()});
+    ASSERT_TRUE(generator.Start("load", profile));
+    EXPECT_TRUE(generator.Running());
+    EXPECT_FALSE(generator.Start("load", profile));
+    generator.Wait();
+    EXPECT_FALSE(generator.Running());
+    
+    // 250 messages are due in [0, 500ms) per node
+    std::vector<LoadNodeStats> stats = generator.GetStats();
+    ASSERT_EQ(stats.size(), 2u);
+    for (const auto& node_stats : stats) {
+        EXPECT_EQ(node_stats.sent, 250u);
+        EXPECT_EQ(node_stats.failed, 0u);
+        EXPECT_EQ(node_stats.send_latency.Count(), 250u);
+        EXPECT_NEAR(node_stats.achieved_rate, 500, 50);
+        EXPECT_NEAR(node_stats.target_rate, 500, 1);
+    }
+    EXPECT_EQ(first.Published(), 250u);
+    EXPECT_EQ(second.Published(), 250u);
+    
+    LoadNodeStats total = generator.GetTotal();
+    EXPECT_EQ(total.address, "*");
+    EXPECT_EQ(total.sent, 500u);
+    
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (received < 250 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_EQ(received, 250);
+    EXPECT_EQ(tracker->GetTotal().Count(), 250u);
+    EXPECT_EQ(tracker->MissingPrefix(), 0u);
+    
+    std::string summary = generator.Summary();
+    EXPECT_EQ(summary.rfind("address\tsent\tfailed\t", 0), 0u);
+    EXPECT_NE(summary.find("\n*\t500\t0\t"), std::string::npos);
+    
+    subscriber.Shutdown();
+}
+
+// Test Stop ends an unbounded run promptly and a new run can start
+TEST_F(LoadGeneratorTest, StopAndRestart) {
+    fake::FakeNode node;
+    ASSERT_TRUE(node.Start());
+    
+    LoadProfile profile;
+    profile.rate = 20;
+    LoadGenerator generator({node.Address()});
+    ASSERT_TRUE(generator.Start("load", profile));
+    std::this_thread::sleep_for(std::chrono::milliseconds(120));
+    
+    auto start = std::chrono::steady_clock::now();
+    generator.Stop();
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(40));
+    EXPECT_FALSE(generator.Running());
+    
+    uint64_t sent = generator.GetTotal().sent;
+    EXPECT_GE(sent, 2u);
+    EXPECT_LE(sent, 4u);
+    
+    // Rates cover the run up to Stop
+    EXPECT_NEAR(generator.GetTotal().achieved_rate, 20, 10);
+    
+    profile.duration = std::chrono::milliseconds(100);
+    ASSERT_TRUE(generator.Start("load", profile));
+    generator.Wait();
+    EXPECT_EQ(generator.GetTotal().sent, 2u);
+}
+
+} // namespace optimum_p2p
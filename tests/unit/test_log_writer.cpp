@@ -0,0 +1,164 @@
+#include <gtest/gtest.h>
+#include "optimum_p2p/log_writer.hpp"
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace optimum_p2p {
+
+class AsyncLogWriterTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        test_dir_ = fs::temp_directory_path() / "optimum_p2p_log_writer_test";
+        fs::create_directories(test_dir_);
+    }
+    
+    void TearDown() override {
+        if (fs::exists(test_dir_)) {
+            fs::remove_all(test_dir_);
+        }
+    }
+    
+    static std::vector<std::string> ReadLines(const fs::path& path) {
+        std::vector<std::string> lines;
+        std::ifstream file(path);
+        std::string line;
+        while (std::getline(file, line)) {
+            lines.push_back(line);
+        }
+        return lines;
+    }
+    
+    fs::path test_dir_;
+};
+
+// Test lines from many threads all arrive intact
+TEST_F(AsyncLogWriterTest, ConcurrentWriters) {
+    auto path = test_dir_ / "concurrent.tsv";
+    const int threads = 8;
+    const int per_thread = 5000;
+    
+    AsyncLogWriter::Options options;
+    options.flush_bytes = 4096;
+    AsyncLogWriter writer(path.string(), options);
+    ASSERT_TRUE(writer.IsOpen());
+    
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([&writer, t]() {
+            for (int i = 0; i < per_thread; i++) {
+                writer.Write(std::to_string(t) + "\t" + std::to_string(i) + "\n");
+            }
+        });
+    }
+    for (auto& w : workers) {
+        w.join();
+    }
+    writer.Flush();
+    
+    auto lines = ReadLines(path);
+    ASSERT_EQ(lines.size(), static_cast<size_t>(threads * per_thread));
+    std::set<std::string> unique(lines.begin(), lines.end());
+    EXPECT_EQ(unique.size(), lines.size());
+}
+
+// Test Flush makes data visible before the time threshold
+TEST_F(AsyncLogWriterTest, FlushWritesPendingData) {
+    auto path = test_dir_ / "flush.tsv";
+    
+    AsyncLogWriter::Options options;
+    options.flush_interval = std::chrono::milliseconds(60000);
+    AsyncLogWriter writer(path.string(), options);
+    
+    writer.Write("first\n");
+    writer.Flush();
+    EXPECT_EQ(ReadLines(path), std::vector<std::string>{"first"});
+}
+
+// Test Close drains the queue and later writes are dropped
+TEST_F(AsyncLogWriterTest, CloseDrainsQueue) {
+    auto path = test_dir_ / "close.tsv";
+    
+    AsyncLogWriter writer(path.string());
+    for (int i = 0; i < 100; i++) {
+        writer.Write("line\n");
+    }
+    writer.Close();
+    writer.Write("dropped\n");
+    writer.Flush();
+    
+    EXPECT_EQ(ReadLines(path).size(), 100u);
+}
+
+// Test writes and flushes racing with Close neither hang nor lose lines
+TEST_F(AsyncLogWriterTest, CloseRacingProducers) {
+    for (int round = 0; round < 20; round++) {
+        auto path = test_dir_ / "race.tsv";
+        
+        AsyncLogWriter::Options options;
+        options.append = false;
+        AsyncLogWriter writer(path.string(), options);
+        
+        std::atomic<bool> stop{false};
+        std::vector<std::thread> workers;
+        for (int t = 0; t < 4; t++) {
+            workers.emplace_back([&]() {
+                while (!stop) {
+                    writer.Write("line\n");
+                    writer.Flush();
+                }
+            });
+        }
+        
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        writer.Close();
+        stop = true;
+        for (auto& w : workers) {
+            w.join();
+        }
+        
+        for (const auto& line : ReadLines(path)) {
+            ASSERT_EQ(line, "line");
+        }
+    }
+}
+
+// Test append and truncate modes
+TEST_F(AsyncLogWriterTest, AppendAndTruncate) {
+    auto path = test_dir_ / "mode.tsv";
+    
+    {
+        AsyncLogWriter writer(path.string());
+        writer.Write("a\n");
+    }
+    {
+        AsyncLogWriter writer(path.string());
+        writer.Write("b\n");
+    }
+    EXPECT_EQ(ReadLines(path), (std::vector<std::string>{"a", "b"}));
+    
+    AsyncLogWriter::Options options;
+    options.append = false;
+    {
+        AsyncLogWriter writer(path.string(), options);
+        writer.Write("c\n");
+    }
+    EXPECT_EQ(ReadLines(path), std::vector<std::string>{"c"});
+}
+
+// Test an unopenable file is reported and writes are ignored
+TEST_F(AsyncLogWriterTest, UnopenableFile) {
+    AsyncLogWriter writer((test_dir_ / "missing" / "dir" / "file.tsv").string());
+    
+    EXPECT_FALSE(writer.IsOpen());
+    writer.Write("ignored\n");
+    writer.Flush();
+}
+
+} // namespace optimum_p2p
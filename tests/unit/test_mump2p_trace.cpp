@@ -0,0 +1,183 @@
+#include <gtest/gtest.h>
+#include "optimum_p2p/mump2p_trace.hpp"
+#include "optimum_p2p/utils.hpp"
+#include "trace.pb.h"
+#include <string>
+#include <vector>
+
+namespace optimum_p2p {
+
+using pubsub::pb::TraceEvent;
+
+class MumP2PTraceTest : public ::testing::Test {
+protected:
+    void SetUp() override {}
+    void TearDown() override {}
+    
+    static std::string Publish(const std::string& peer, const std::string& id, int64_t ts) {
+        TraceEvent event;
+        event.set_type(TraceEvent::PUBLISH_MESSAGE);
+        event.set_peerid(peer);
+        event.set_timestamp(ts);
+        event.mutable_publishmessage()->set_messageid(id);
+        event.mutable_publishmessage()->set_topic("t");
+        return event.SerializeAsString();
+    }
+    
+    static std::string Deliver(const std::string& peer, const std::string& id, int64_t ts) {
+        TraceEvent event;
+        event.set_type(TraceEvent::DELIVER_MESSAGE);
+        event.set_peerid(peer);
+        event.set_timestamp(ts);
+        event.mutable_delivermessage()->set_topic("t");
+        event.mutable_delivermessage()->set_messageid(id);
+        event.mutable_delivermessage()->set_receivedfrom("X");
+        return event.SerializeAsString();
+    }
+};
+
+// Test decoding events in the shared TraceEvent layout
+TEST_F(MumP2PTraceTest, DecodeEvent) {
+    std::string data = Deliver("peer-a", "msg-1", 123456789);
+    
+    MumP2PTraceEvent event;
+    ASSERT_TRUE(DecodeMumP2PTrace(data, event));
+    EXPECT_EQ(event.type, int32_t(TraceEvent::DELIVER_MESSAGE));
+    EXPECT_EQ(event.peer_id, "peer-a");
+    EXPECT_EQ(event.message_id, "msg-1");
+    EXPECT_EQ(event.timestamp, 123456789);
+    
+    // Events without a message body
+    TraceEvent join;
+    join.set_type(TraceEvent::JOIN);
+    join.set_peerid("peer-a");
+    join.mutable_join()->set_topic("t");
+    ASSERT_TRUE(DecodeMumP2PTrace(join.SerializeAsString(), event));
+    EXPECT_EQ(event.type, int32_t(TraceEvent::JOIN));
+    EXPECT_TRUE(event.message_id.empty());
+}
+
+// Test unknown event types and fields are tolerated
+TEST_F(MumP2PTraceTest, DecodeUnknownFields) {
+    // type = 20, peerID = "p", fixed64 field 40, unknown body in field 30,
+    // deliver body = {messageID = "m"}
+    std::string data = {0x08, 0x14, 0x12, 0x01, 'p'};
+    data += std::string("\xc1\x02", 2) + std::string(8, '\x01');
+    data += std::string("\xf2\x01\x03\x0a\x01x", 6);
+    data += std::string("\x3a\x03\x0a\x01m", 5);
+    
+    MumP2PTraceEvent event;
+    ASSERT_TRUE(DecodeMumP2PTrace(data, event));
+    EXPECT_EQ(event.type, 20);
+    EXPECT_EQ(event.peer_id, "p");
+    EXPECT_EQ(event.message_id, "m");
+}
+
+// Test malformed input is rejected
+TEST_F(MumP2PTraceTest, DecodeMalformed) {
+    MumP2PTraceEvent event;
+    
+    EXPECT_FALSE(DecodeMumP2PTrace("", event)); // no type
+    EXPECT_FALSE(DecodeMumP2PTrace(std::string("\x08", 1), event)); // truncated varint
+    EXPECT_FALSE(DecodeMumP2PTrace(std::string("\x08\x03\x12\x05" "ab", 6), event)); // length past end
+    EXPECT_FALSE(DecodeMumP2PTrace(std::string("\x08\x03\x0b", 3), event)); // group
+    EXPECT_FALSE(DecodeMumP2PTrace(std::string("\x08\x03\x3a\x02\x0a\x05", 6), event)); // bad body
+}
+
+// Test time-to-all-nodes is recorded when the last expected node sees a message
+TEST_F(MumP2PTraceTest, PropagationComplete) {
+    PropagationTracker tracker(3);
+    
+    EXPECT_TRUE(tracker.Add(Publish("A", "m1", 1000)));
+    EXPECT_TRUE(tracker.Add(Deliver("B", "m1", 3000)));
+    
+    MessageTimeline timeline;
+    ASSERT_TRUE(tracker.GetTimeline("m1", timeline));
+    EXPECT_TRUE(timeline.published);
+    EXPECT_FALSE(timeline.complete);
+    EXPECT_EQ(timeline.origin, 1000);
+    ASSERT_EQ(timeline.first_seen.size(), 2u);
+    EXPECT_EQ(timeline.first_seen[0].first, "28"); // base58("A")
+    EXPECT_EQ(timeline.first_seen[1].second, 3000);
+    
+    EXPECT_EQ(tracker.GetStats().complete_messages, 0u);
+    
+    // A repeat sighting does not count as a new node
+    tracker.Add(Deliver("B", "m1", 4000));
+    EXPECT_EQ(tracker.GetStats().complete_messages, 0u);
+    
+    tracker.Add(Deliver("C", "m1", 9000));
+    PropagationStats stats = tracker.GetStats();
+    EXPECT_EQ(stats.complete_messages, 1u);
+    EXPECT_EQ(stats.time_to_all_nodes.Count(), 1u);
+    EXPECT_EQ(stats.time_to_all_nodes.Max(), 8000u);
+    EXPECT_EQ(stats.time_to_node.Count(), 3u);
+    EXPECT_EQ(stats.time_to_node.Min(), 0u);
+    
+    // The timeline of a complete message keeps every node's first sighting
+    ASSERT_TRUE(tracker.GetTimeline("m1", timeline));
+    EXPECT_TRUE(timeline.complete);
+    ASSERT_EQ(timeline.first_seen.size(), 3u);
+    EXPECT_EQ(timeline.first_seen[1].second, 3000);
+    EXPECT_EQ(timeline.first_seen[2].second, 9000);
+    
+    // Late events change neither the timeline nor the histograms
+    tracker.Add(Deliver("D", "m1", 10000));
+    ASSERT_TRUE(tracker.GetTimeline("m1", timeline));
+    EXPECT_EQ(timeline.first_seen.size(), 3u);
+    EXPECT_EQ(tracker.GetStats().time_to_node.Count(), 3u);
+}
+
+// Test percentiles over many messages
+TEST_F(MumP2PTraceTest, PropagationPercentiles) {
+    PropagationTracker tracker(2);
+    
+    for (int i = 1; i <= 100; i++) {
+        std::string id = "m" + std::to_string(i);
+        tracker.Add(Publish("A", id, 0));
+        tracker.Add(Deliver("B", id, i * 1000));
+    }
+    
+    PropagationStats stats = tracker.GetStats();
+    EXPECT_EQ(stats.complete_messages, 100u);
+    EXPECT_NEAR(double(stats.time_to_all_nodes.Percentile(50)), 50000.0, 50000.0 * 0.032);
+    EXPECT_NEAR(double(stats.time_to_all_nodes.Percentile(99)), 99000.0, 99000.0 * 0.032);
+}
+
+// Test the store is bounded and counts incomplete evictions
+TEST_F(MumP2PTraceTest, StoreBounded) {
+    PropagationTracker tracker(2, 2);
+    
+    tracker.Add(Publish("A", "m1", 0));
+    tracker.Add(Publish("A", "m2", 0));
+    tracker.Add(Publish("A", "m3", 0)); // evicts m1
+    
+    MessageTimeline timeline;
+    EXPECT_FALSE(tracker.GetTimeline("m1", timeline));
+    EXPECT_TRUE(tracker.GetTimeline("m3", timeline));
+    
+    PropagationStats stats = tracker.GetStats();
+    EXPECT_EQ(stats.tracked_messages, 2u);
+    EXPECT_EQ(stats.evicted_incomplete, 1u);
+    
+    tracker.Reset();
+    EXPECT_EQ(tracker.GetStats().tracked_messages, 0u);
+}
+
+// Test the trace file line format
+TEST_F(MumP2PTraceTest, TraceLine) {
+    std::string event = Deliver(std::string("\x00\x01", 2), "\xab\xcd", 42);
+    
+    std::vector<std::string> lines;
+    auto callback = [&lines](const std::string& line) { lines.push_back(line); };
+    
+    HandleOptimumP2PTrace(std::string_view(event), true, callback);
+    ASSERT_EQ(lines.size(), 1u);
+    EXPECT_EQ(lines[0], "3\t12\t\tabcd\t\t42");
+    
+    std::vector<uint8_t> garbage = {0xff};
+    HandleOptimumP2PTrace(garbage, true, callback);
+    EXPECT_EQ(lines.size(), 1u);
+}
+
+} // namespace optimum_p2p
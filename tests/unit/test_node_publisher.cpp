@@ -0,0 +1,105 @@
+#include <gtest/gtest.h>
+#include "fake_node.hpp"
+#include "optimum_p2p/node_publisher.hpp"
+#include "optimum_p2p/utils.hpp"
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace optimum_p2p {
+
+class NodePublisherTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        log_path_ = fs::temp_directory_path() / "optimum_p2p_node_publisher_test.tsv";
+        fs::remove(log_path_);
+    }
+    
+    void TearDown() override {
+        fs::remove(log_path_);
+    }
+    
+    std::vector<std::string> ReadLines() const {
+        std::vector<std::string> lines;
+        std::ifstream file(log_path_);
+        std::string line;
+        while (std::getline(file, line)) {
+            lines.push_back(line);
+        }
+        return lines;
+    }
+    
+    // Publish returns once the message is written, before the node has read it
+    static bool WaitForPublished(const fake::FakeNode& node, uint64_t count) {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (node.Published() < count && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        return node.Published() >= count;
+    }
+    
+    fs::path log_path_;
+};
+
+// Test published messages are logged as address, size and hash
+TEST_F(NodePublisherTest, LogsPublishedMessages) {
+    fake::FakeNode node;
+    ASSERT_TRUE(node.Start());
+    
+    AsyncLogWriter writer(log_path_.string());
+    NodePublisher publisher(node.Address());
+    publisher.SetLogWriter(&writer, std::chrono::milliseconds(60000));
+    
+    std::vector<uint8_t> message = {'h', 'e', 'l', 'l', 'o'};
+    for (int i = 0; i < 3; i++) {
+        ASSERT_TRUE(publisher.Publish("topic", message));
+        publisher.Log(message);
+    }
+    
+    // Lines stay buffered until handed over
+    writer.Flush();
+    EXPECT_TRUE(ReadLines().empty());
+    
+    publisher.FlushLog();
+    writer.Flush();
+    auto lines = ReadLines();
+    ASSERT_EQ(lines.size(), 3u);
+    EXPECT_EQ(lines[0], node.Address() + "\t5\t" + SHA256Hex(message));
+    EXPECT_TRUE(WaitForPublished(node, 3));
+}
+
+// Test a publish after the node restarts reconnects and succeeds
+TEST_F(NodePublisherTest, ReconnectsAfterNodeRestart) {
+    auto first = std::make_unique<fake::FakeNode>();
+    ASSERT_TRUE(first->Start());
+    std::string address = first->Address();
+    
+    NodePublisher publisher(address);
+    ASSERT_TRUE(publisher.Publish("topic", {'a'}));
+    first->Stop();
+    first.reset();
+    
+    fake::FakeNode second;
+    ASSERT_TRUE(second.Start(address));
+    
+    // A write can still succeed on the dying stream and be lost, but the
+    // failure that follows reconnects
+    for (int attempt = 0; attempt < 5 && second.Published() == 0; attempt++) {
+        publisher.Publish("topic", {'b'});
+        WaitForPublished(second, 1);
+    }
+    ASSERT_GE(second.Published(), 1u);
+    
+    // Shutdown closes the connection; the next publish opens a new one
+    publisher.Shutdown();
+    uint64_t published = second.Published();
+    EXPECT_TRUE(publisher.Publish("topic", {'c'}));
+    EXPECT_TRUE(WaitForPublished(second, published + 1));
+}
+
+} // namespace optimum_p2p
@@ -0,0 +1,236 @@
+#include <gtest/gtest.h>
+#include "fake_node.hpp"
+#include "optimum_p2p/client.hpp"
+#include "optimum_p2p/latency_tracker.hpp"
+#include "optimum_p2p/load_generator.hpp"
+#include "optimum_p2p/multi_client.hpp"
+#include "optimum_p2p/payload_generator.hpp"
+#include <atomic>
+#include <bitset>
+#include <climits>
+#include <cstring>
+#include <mutex>
+#include <regex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace optimum_p2p {
+
+class PayloadGeneratorTest : public ::testing::Test {
+protected:
+    void SetUp() override {}
+    void TearDown() override {}
+    
+    static std::string AsString(const std::vector<uint8_t>& data) {
+        return std::string(data.begin(), data.end());
+    }
+    
+    // Builds "msg <index>/<count>", ignoring data
+    class CountingGenerator : public PayloadGenerator {
+    public:
+        void Generate(const std::vector<uint8_t>& /*data*/, int index, int count,
+                      std::vector<uint8_t>& out) override {
+            calls++;
+            std::string text = "msg " + std::to_string(index) + "/" + std::to_string(count);
+            out.assign(text.begin(), text.end());
+        }
+        
+        std::atomic<int> calls{0};
+    };
+};
+
+// Test splitmix64 against its reference output and seeding determinism
+TEST_F(PayloadGeneratorTest, FastRandomIsDeterministic) {
+    uint64_t state = 0;
+    EXPECT_EQ(FastRandom::SplitMix64(state), 0xe220a8397b1dcdafULL);
+    
+    FastRandom first(42);
+    FastRandom second(42);
+    FastRandom other(43);
+    bool differs = false;
+    for (int i = 0; i < 1000; i++) {
+        uint64_t value = first.Next();
+        EXPECT_EQ(value, second.Next());
+        differs |= value != other.Next();
+    }
+    EXPECT_TRUE(differs);
+}
+
+// Test output bits are balanced and Fill covers partial words
+TEST_F(PayloadGeneratorTest, FastRandomBitsAndFill) {
+    FastRandom random(7);
+    size_t ones = 0;
+    for (int i = 0; i < 10000; i++) {
+        ones += std::bitset<64>(random.Next()).count();
+    }
+    EXPECT_NEAR(ones / 640000.0, 0.5, 0.005);
+    
+    std::vector<uint8_t> buffer(23, 0);
+    random.Fill(buffer.data(), 21);
+    EXPECT_NE(std::count(buffer.begin(), buffer.begin() + 21, 0), 21);
+    EXPECT_EQ(buffer[21], 0);
+    EXPECT_EQ(buffer[22], 0);
+}
+
+// Test each thread gets its own stream
+TEST_F(PayloadGeneratorTest, ThreadLocalStreamsDiffer) {
+    std::mutex mutex;
+    std::set<uint64_t> firsts;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([&]() {
+            uint64_t value = FastRandom::ThreadLocal().Next();
+            std::lock_guard<std::mutex> lock(mutex);
+            firsts.insert(value);
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(firsts.size(), 4u);
+}
+
+// Test the prefix matches MultiPublishClient's format and parses back
+TEST_F(PayloadGeneratorTest, FormatPublishPrefix) {
+    char buffer[kMaxPublishPrefixSize];
+    size_t length = FormatPublishPrefix(1700000000123456789LL, 256, buffer);
+    EXPECT_EQ(std::string(buffer, length), "[1700000000123456789 256] ");
+    
+    int64_t nanos = 0;
+    size_t size = 0;
+    ASSERT_TRUE(ParsePublishPrefix(std::string_view(buffer, length), nanos, size));
+    EXPECT_EQ(nanos, 1700000000123456789LL);
+    EXPECT_EQ(size, 256u);
+    
+    // The longest prefix fits
+    EXPECT_EQ(FormatPublishPrefix(INT64_MIN, SIZE_MAX, buffer), kMaxPublishPrefixSize);
+}
+
+// Test the default generator reproduces the Go client's payloads
+TEST_F(PayloadGeneratorTest, DefaultFormat) {
+    DefaultPayloadGenerator generator;
+    std::vector<uint8_t> data = {'h', 'e', 'l', 'l', 'o'};
+    std::vector<uint8_t> out;
+    
+    generator.Generate(data, 0, 1, out);
+    std::string single = AsString(out);
+    EXPECT_TRUE(std::regex_match(single, std::regex(R"(\[\d{19} 5\] hello)"))) << single;
+    
+    generator.Generate(data, 6, 10, out);
+    std::string first = AsString(out);
+    EXPECT_TRUE(std::regex_match(first, std::regex(R"(\[\d{19} 8\] 7 - [0-9a-f]{8} XXX)"))) << first;
+    
+    generator.Generate(data, 6, 10, out);
+    EXPECT_NE(AsString(out).substr(first.size() - 12), first.substr(first.size() - 12));
+}
+
+// Test the random generator's size, prefix and buffer reuse
+TEST_F(PayloadGeneratorTest, RandomPayload) {
+    RandomPayloadGenerator generator(1000);
+    std::vector<uint8_t> out;
+    
+    generator.Generate({}, 0, 1, out);
+    int64_t nanos = 0;
+    size_t size = 0;
+    ASSERT_TRUE(ParsePublishPrefix(std::string_view(reinterpret_cast<const char*>(out.data()), out.size()),
+                                   nanos, size));
+    EXPECT_EQ(size, 1000u);
+    EXPECT_EQ(out.size(), 27u + 1000u);
+    
+    std::vector<uint8_t> previous = out;
+    const uint8_t* storage = out.data();
+    generator.Generate({}, 1, 2, out);
+    EXPECT_EQ(out.data(), storage);
+    EXPECT_NE(std::memcmp(out.data() + 27, previous.data() + 27, 1000), 0);
+}
+
+// Test MultiPublishClient publishes what a custom generator builds
+TEST_F(PayloadGeneratorTest, MultiPublishUsesGenerator) {
+    fake::FakeNodeOptions options;
+    options.base64_payloads = false;
+    fake::FakeNode node(options);
+    ASSERT_TRUE(node.Start());
+    
+    std::mutex mutex;
+    std::vector<std::string> received;
+    P2PClient subscriber(node.Address());
+    subscriber.SetMessageCallback([&](const P2PMessage& message) {
+        std::lock_guard<std::mutex> lock(mutex);
+        received.push_back(AsString(message.message));
+    });
+    ASSERT_TRUE(subscriber.Subscribe("topic"));
+    ASSERT_TRUE(node.WaitForSubscribers("topic", 1, std::chrono::seconds(5)));
+    
+    auto generator = std::make_shared<CountingGenerator>();
+    {
+        MultiPublishClient client({node.Address()});
+        client.SetPayloadGenerator(generator);
+        client.PublishAll("topic", {'x'}, 3);
+    }
+    EXPECT_EQ(generator->calls, 3);
+    
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (std::chrono::steady_clock::now() < deadline) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (received.size() >= 3) {
+                break;
+            }
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    
+    std::lock_guard<std::mutex> lock(mutex);
+    EXPECT_EQ(received, (std::vector<std::string>{"msg 0/3", "msg 1/3", "msg 2/3"}));
+    subscriber.Shutdown();
+}
+
+// Test LoadGenerator builds each message through a custom generator
+TEST_F(PayloadGeneratorTest, LoadGeneratorUsesGenerator) {
+    fake::FakeNodeOptions options;
+    options.base64_payloads = false;
+    fake::FakeNode node(options);
+    ASSERT_TRUE(node.Start());
+    
+    std::mutex mutex;
+    std::vector<std::string> received;
+    P2PClient subscriber(node.Address());
+    subscriber.SetMessageCallback([&](const P2PMessage& message) {
+        std::lock_guard<std::mutex> lock(mutex);
+        received.push_back(AsString(message.message));
+    });
+    ASSERT_TRUE(subscriber.Subscribe("topic"));
+    ASSERT_TRUE(node.WaitForSubscribers("topic", 1, std::chrono::seconds(5)));
+    
+    // 100/s for 30ms: messages are due at 0, 10 and 20ms
+    LoadProfile profile;
+    profile.rate = 100;
+    profile.duration = std::chrono::milliseconds(30);
+    
+    auto generator = std::make_shared<CountingGenerator>();
+    LoadGenerator load({node.Address()});
+    load.SetPayloadGenerator(generator);
+    ASSERT_TRUE(load.Start("topic", profile));
+    load.Wait();
+    EXPECT_EQ(generator->calls, 3);
+    EXPECT_EQ(load.GetTotal().sent, 3u);
+    
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (std::chrono::steady_clock::now() < deadline) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (received.size() >= 3) {
+                break;
+            }
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    
+    std::lock_guard<std::mutex> lock(mutex);
+    EXPECT_EQ(received, (std::vector<std::string>{"msg 0/1", "msg 1/1", "msg 2/1"}));
+    subscriber.Shutdown();
+}
+
+} // namespace optimum_p2p
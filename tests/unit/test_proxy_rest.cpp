@@ -0,0 +1,148 @@
+#include <gtest/gtest.h>
+#include "fake_proxy.hpp"
+#include "optimum_p2p/proxy_client.hpp"
+#include <atomic>
+#include <future>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace optimum_p2p {
+
+class ProxyRestTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        ASSERT_TRUE(proxy_.Start());
+    }
+    
+    void TearDown() override {
+        proxy_.Stop();
+    }
+    
+    fake::FakeProxy proxy_;
+};
+
+// Test sequential REST calls share one kept-alive connection
+TEST_F(ProxyRestTest, SequentialCallsReuseConnection) {
+    ProxyClient client(proxy_.RestUrl(), proxy_.GrpcAddress());
+    
+    ASSERT_TRUE(client.Subscribe("client_1", "topic"));
+    for (int i = 0; i < 100; i++) {
+        ASSERT_TRUE(client.Publish("client_1", "topic", "message " + std::to_string(i)));
+    }
+    
+    // Bodies past libcurl's 100-continue threshold go out without waiting
+    ASSERT_TRUE(client.Publish("client_1", "topic", std::string(64 << 10, 'z')));
+    
+    EXPECT_EQ(proxy_.Published(), 101u);
+    EXPECT_EQ(proxy_.Connections(), 1u);
+}
+
+// Test concurrent callers each get a pooled handle, and each handle keeps
+// reusing its own connection
+TEST_F(ProxyRestTest, ConcurrentCallsReusePooledHandles) {
+    ProxyClient client(proxy_.RestUrl(), proxy_.GrpcAddress());
+    
+    std::atomic<int> failures{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([&, t]() {
+            for (int i = 0; i < 50; i++) {
+                if (!client.Publish("client_" + std::to_string(t), "topic", "payload")) {
+                    failures++;
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    
+    EXPECT_EQ(failures, 0);
+    EXPECT_EQ(proxy_.Published(), 200u);
+    
+    // At most one handle, and so one connection, per concurrent caller
+    size_t connections = proxy_.Connections();
+    EXPECT_GE(connections, 1u);
+    EXPECT_LE(connections, 4u);
+    
+    // Later calls reuse the pooled handles and their open connections
+    for (int i = 0; i < 50; i++) {
+        ASSERT_TRUE(client.Publish("client_1", "topic", "payload"));
+    }
+    EXPECT_EQ(proxy_.Connections(), connections);
+}
+
+// Test an error response leaves the pooled handle usable
+TEST_F(ProxyRestTest, ErrorResponseKeepsHandleUsable) {
+    ProxyClient missing(proxy_.RestUrl() + "/missing", proxy_.GrpcAddress());
+    EXPECT_FALSE(missing.Publish("client_1", "topic", "lost"));
+    EXPECT_FALSE(missing.Publish("client_1", "topic", "lost"));
+    EXPECT_EQ(proxy_.Connections(), 1u);
+    
+    ProxyClient client(proxy_.RestUrl(), proxy_.GrpcAddress());
+    EXPECT_TRUE(client.Publish("client_1", "topic", "kept"));
+    EXPECT_EQ(proxy_.Published(), 1u);
+    
+    // Nothing listens on the proxy's port once it stops
+    proxy_.Stop();
+    EXPECT_FALSE(client.Publish("client_1", "topic", "refused"));
+}
+
+// Test async publishes all complete and their futures report success
+TEST_F(ProxyRestTest, PublishAsyncFutures) {
+    ProxyClient client(proxy_.RestUrl(), proxy_.GrpcAddress());
+    
+    std::vector<std::future<bool>> results;
+    for (int i = 0; i < 200; i++) {
+        results.push_back(client.PublishAsync("client_1", "topic", "message " + std::to_string(i)));
+    }
+    for (auto& result : results) {
+        EXPECT_TRUE(result.get());
+    }
+    
+    EXPECT_EQ(proxy_.Published(), 200u);
+    EXPECT_LE(proxy_.Connections(), 64u);
+}
+
+// Test the callback form and that the window bounds concurrent connections
+TEST_F(ProxyRestTest, PublishAsyncCallbacksRespectWindow) {
+    ProxyClient client(proxy_.RestUrl(), proxy_.GrpcAddress());
+    client.SetMaxInFlight(2);
+    
+    std::atomic<int> succeeded{0};
+    std::atomic<int> failed{0};
+    for (int i = 0; i < 100; i++) {
+        client.PublishAsync("client_1", "topic", "payload", [&](bool ok) {
+            (ok ? succeeded : failed)++;
+        });
+    }
+    client.WaitAsync();
+    
+    EXPECT_EQ(succeeded, 100);
+    EXPECT_EQ(failed, 0);
+    EXPECT_EQ(proxy_.Published(), 100u);
+    EXPECT_LE(proxy_.Connections(), 2u);
+}
+
+// Test async failures are reported and the destructor completes what is left
+TEST_F(ProxyRestTest, PublishAsyncReportsFailures) {
+    std::atomic<int> completed{0};
+    {
+        ProxyClient missing(proxy_.RestUrl() + "/missing", proxy_.GrpcAddress());
+        EXPECT_FALSE(missing.PublishAsync("client_1", "topic", "lost").get());
+        
+        for (int i = 0; i < 10; i++) {
+            missing.PublishAsync("client_1", "topic", "lost", [&](bool) {
+                completed++;
+            });
+        }
+    }
+    EXPECT_EQ(completed, 10);
+    
+    ProxyClient client(proxy_.RestUrl(), proxy_.GrpcAddress());
+    proxy_.Stop();
+    EXPECT_FALSE(client.PublishAsync("client_1", "topic", "refused").get());
+}
+
+} // namespace optimum_p2p
@@ -0,0 +1,60 @@
+#include <gtest/gtest.h>
+#include "optimum_p2p/sha256.hpp"
+#include "optimum_p2p/utils.hpp"
+#include <vector>
+#include <string>
+
+namespace optimum_p2p {
+
+class Sha256HasherTest : public ::testing::Test {
+protected:
+    void SetUp() override {}
+    void TearDown() override {}
+};
+
+// Test known digests
+TEST_F(Sha256HasherTest, KnownVectors) {
+    Sha256Hasher hasher;
+    
+    EXPECT_EQ(hasher.FinalHex(), "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+    
+    hasher.Update(std::string_view("Hello World"));
+    EXPECT_EQ(hasher.FinalHex(), "a591a6d40bf420404a011733cfb7b190d62c65bf0bcda32b57b277d9ad9f146e");
+    
+    hasher.Update(std::string_view("abc"));
+    Sha256Hasher::Digest digest;
+    ASSERT_TRUE(hasher.Final(digest));
+    EXPECT_EQ(digest[0], 0xba);
+    EXPECT_EQ(digest[31], 0xad);
+}
+
+// Test that any split of the input gives the one-shot digest
+TEST_F(Sha256HasherTest, IncrementalMatchesOneShot) {
+    std::vector<uint8_t> data(1000);
+    for (size_t i = 0; i < data.size(); i++) {
+        data[i] = static_cast<uint8_t>(i * 31);
+    }
+    std::string expected = SHA256Hex(data);
+    
+    Sha256Hasher hasher;
+    for (size_t split : {0, 1, 63, 64, 65, 500, 999, 1000}) {
+        hasher.Update(data.data(), split);
+        hasher.Update(data.data() + split, data.size() - split);
+        EXPECT_EQ(hasher.FinalHex(), expected) << "split=" << split;
+    }
+}
+
+// Test Reset discards pending data
+TEST_F(Sha256HasherTest, ResetDiscardsData) {
+    Sha256Hasher hasher;
+    hasher.Update(std::string_view("garbage"));
+    hasher.Reset();
+    hasher.Update(std::string_view("Hello World"));
+    
+    std::array<char, 64> hex;
+    ASSERT_TRUE(hasher.FinalHex(hex));
+    EXPECT_EQ(std::string(hex.data(), hex.size()),
+              "a591a6d40bf420404a011733cfb7b190d62c65bf0bcda32b57b277d9ad9f146e");
+}
+
+} // namespace optimum_p2p
@@ -267,6 +267,169 @@ TEST_F(UtilsTest, ParseMessage_EmptyJSON) {
     }
 }
 
+// Test MessageDecoder view-based decoding
+TEST_F(UtilsTest, MessageDecoder_ViewFields) {
+    std::string json_str = R"({
+        "MessageID": "test-message-123",
+        "Topic": "test-topic",
+        "Message": "SGVsbG8gV29ybGQ=",
+        "SourceNodeID": "node-1"
+    })";
+    
+    MessageDecoder decoder;
+    P2PMessageView view;
+    ASSERT_TRUE(decoder.Decode(json_str, view));
+    
+    EXPECT_EQ(view.message_id, "test-message-123");
+    EXPECT_EQ(view.topic, "test-topic");
+    EXPECT_EQ(view.source_node_id, "node-1");
+    EXPECT_EQ(view.message, "Hello World");
+}
+
+TEST_F(UtilsTest, MessageDecoder_InvalidJSON) {
+    MessageDecoder decoder;
+    P2PMessageView view;
+    view.topic = "stale";
+    
+    EXPECT_FALSE(decoder.Decode("{ invalid json }", view));
+    EXPECT_TRUE(view.topic.empty());
+    EXPECT_TRUE(view.message.empty());
+}
+
+TEST_F(UtilsTest, MessageDecoder_ReusedAcrossMessages) {
+    MessageDecoder decoder;
+    P2PMessageView view;
+    
+    ASSERT_TRUE(decoder.Decode(R"({"Topic": "first", "Message": "SGVsbG8gV29ybGQ="})", view));
+    EXPECT_EQ(view.topic, "first");
+    EXPECT_EQ(view.message, "Hello World");
+    
+    ASSERT_TRUE(decoder.Decode(R"({"Topic": "second", "Message": "plain text"})", view));
+    EXPECT_EQ(view.topic, "second");
+    EXPECT_EQ(view.message, "plain text");
+    EXPECT_TRUE(view.message_id.empty());
+}
+
+TEST_F(UtilsTest, MessageDecoder_BorrowsUnescapedFields) {
+    std::string json_str = R"({"MessageID": "msg-1", "Topic": "topic-1", "Message": "Hello World"})";
+    
+    MessageDecoder decoder;
+    P2PMessageView view;
+    ASSERT_TRUE(decoder.Decode(json_str, view));
+    
+    // Fields without escape sequences point straight into the input buffer
+    EXPECT_GE(view.topic.data(), json_str.data());
+    EXPECT_LT(view.topic.data(), json_str.data() + json_str.size());
+    EXPECT_GE(view.message.data(), json_str.data());
+    EXPECT_LT(view.message.data(), json_str.data() + json_str.size());
+}
+
+TEST_F(UtilsTest, MessageDecoder_EscapeSequences) {
+    std::string json_str = R"({"Topic": "a\"b\\c\/d\n", "Message": "caf\u00e9 \ud83d\ude00", "SourceNodeID": "\u0041"})";
+    
+    MessageDecoder decoder;
+    P2PMessageView view;
+    ASSERT_TRUE(decoder.Decode(json_str, view));
+    
+    EXPECT_EQ(view.topic, "a\"b\\c/d\n");
+    EXPECT_EQ(view.message, "caf\xc3\xa9 \xf0\x9f\x98\x80");
+    EXPECT_EQ(view.source_node_id, "A");
+}
+
+TEST_F(UtilsTest, MessageDecoder_SkipsUnknownMembers) {
+    std::string json_str = R"({
+        "Extra": {"nested": [1, 2.5e3, -3, true, false, null, "x\"y"]},
+        "MessageID": "msg-1",
+        "Count": 42,
+        "Message": null,
+        "Topic": "topic-1"
+    })";
+    
+    MessageDecoder decoder;
+    P2PMessageView view;
+    ASSERT_TRUE(decoder.Decode(json_str, view));
+    
+    EXPECT_EQ(view.message_id, "msg-1");
+    EXPECT_EQ(view.topic, "topic-1");
+    EXPECT_TRUE(view.message.empty());
+}
+
+TEST_F(UtilsTest, MessageDecoder_MalformedInput) {
+    MessageDecoder decoder;
+    P2PMessageView view;
+    
+    EXPECT_FALSE(decoder.Decode("", view));
+    EXPECT_FALSE(decoder.Decode(R"({"Topic": "unterminated)", view));
+    EXPECT_FALSE(decoder.Decode(R"({"Topic": "a" "Message": "b"})", view));
+    EXPECT_FALSE(decoder.Decode(R"({"Topic": "a"} trailing)", view));
+    EXPECT_FALSE(decoder.Decode(R"({"Topic": "\x"})", view));
+    EXPECT_FALSE(decoder.Decode(R"({"Topic": "\ud83d"})", view));
+    EXPECT_FALSE(decoder.Decode(R"(["Topic", "a"])", view));
+    EXPECT_TRUE(view.topic.empty());
+    
+    EXPECT_TRUE(decoder.Decode(" { } ", view));
+}
+
+TEST_F(UtilsTest, P2PMessageView_ToOwned) {
+    std::string json_str = R"({"MessageID": "msg-1", "Topic": "topic-1", "Message": "Hello World", "SourceNodeID": "node-1"})";
+    
+    MessageDecoder decoder;
+    P2PMessageView view;
+    ASSERT_TRUE(decoder.Decode(json_str, view));
+    P2PMessage owned = view.ToOwned();
+    
+    // Owned copy must survive the decoder moving on to another message
+    decoder.Decode(R"({"Topic": "other"})", view);
+    
+    P2PMessage expected = ParseMessage(std::vector<uint8_t>(json_str.begin(), json_str.end()));
+    EXPECT_EQ(owned.message_id, expected.message_id);
+    EXPECT_EQ(owned.topic, expected.topic);
+    EXPECT_EQ(owned.source_node_id, expected.source_node_id);
+    EXPECT_EQ(owned.message, expected.message);
+    EXPECT_EQ(std::string(owned.message.begin(), owned.message.end()), "Hello World");
+}
+
+// Test explicit payload encodings
+TEST_F(UtilsTest, ParseMessage_PayloadEncoding) {
+    std::string json_str = R"({"Topic": "t", "Message": "SGVsbG8gV29ybGQ="})";
+    
+    P2PMessage raw = ParseMessage(json_str, PayloadEncoding::Raw);
+    EXPECT_EQ(std::string(raw.message.begin(), raw.message.end()), "SGVsbG8gV29ybGQ=");
+    
+    P2PMessage b64 = ParseMessage(json_str, PayloadEncoding::Base64);
+    EXPECT_EQ(std::string(b64.message.begin(), b64.message.end()), "Hello World");
+    
+    // Base64 mode rejects payloads that are not valid padded base64
+    P2PMessage invalid = ParseMessage(R"({"Topic": "t", "Message": "Hello World"})", PayloadEncoding::Base64);
+    EXPECT_TRUE(invalid.topic.empty());
+    EXPECT_TRUE(invalid.message.empty());
+}
+
+// Test Auto keeps anything that is not canonical base64 as-is
+TEST_F(UtilsTest, ParseMessage_AutoFallsBackToRaw) {
+    std::vector<std::string> raw_payloads = {"abcde+", "ab=cd", "SGVsbG8", "Zg==Zg==", "Hello World", "QR==", "QUJ="};
+    
+    for (const auto& payload : raw_payloads) {
+        std::string json_str = R"({"Message": ")" + payload + R"("})";
+        P2PMessage msg = ParseMessage(json_str, PayloadEncoding::Auto);
+        EXPECT_EQ(std::string(msg.message.begin(), msg.message.end()), payload);
+    }
+}
+
+TEST_F(UtilsTest, MessageDecoder_Base64Encoding) {
+    MessageDecoder decoder;
+    P2PMessageView view;
+    
+    ASSERT_TRUE(decoder.Decode(R"({"Topic": "t", "Message": "Zm9vYmFy"})", view, PayloadEncoding::Base64));
+    EXPECT_EQ(view.message, "foobar");
+    
+    EXPECT_FALSE(decoder.Decode(R"({"Topic": "t", "Message": "Zm9v YmFy"})", view, PayloadEncoding::Base64));
+    EXPECT_TRUE(view.topic.empty());
+    
+    ASSERT_TRUE(decoder.Decode(R"({"Topic": "t", "Message": "Zm9vYmFy"})", view, PayloadEncoding::Raw));
+    EXPECT_EQ(view.message, "Zm9vYmFy");
+}
+
 // Test WriteToFile functionality
 TEST_F(UtilsTest, WriteToFile_WithHeader) {
     auto filepath = test_dir_ / "output.txt";
@@ -2,6 +2,7 @@
 #include "optimum_p2p/utils.hpp"
 #include <vector>
 #include <string>
+#include <array>
 
 namespace optimum_p2p {
 
@@ -61,5 +62,50 @@ TEST_F(HexUtilsTest, HeadHex_BinaryData) {
     EXPECT_EQ(hex, "00ff807f");
 }
 
+// Test HexEncode over every byte value
+TEST_F(HexUtilsTest, HexEncode_AllByteValues) {
+    const char* digits = "0123456789abcdef";
+    std::vector<uint8_t> data(256);
+    for (size_t i = 0; i < data.size(); i++) {
+        data[i] = static_cast<uint8_t>(i);
+    }
+    
+    std::string hex(512, '?');
+    HexEncode(data.data(), data.size(), hex.data());
+    
+    for (size_t i = 0; i < data.size(); i++) {
+        EXPECT_EQ(hex[2 * i], digits[i >> 4]);
+        EXPECT_EQ(hex[2 * i + 1], digits[i & 0x0F]);
+    }
+}
+
+// Test the non-allocating SHA256Hex overload matches the string version
+TEST_F(HexUtilsTest, SHA256Hex_ArrayOverload) {
+    std::string text = "Hello World";
+    std::vector<uint8_t> data(text.begin(), text.end());
+    
+    std::array<char, 64> hex;
+    SHA256Hex(data.data(), data.size(), hex);
+    
+    EXPECT_EQ(std::string(hex.data(), hex.size()),
+              "a591a6d40bf420404a011733cfb7b190d62c65bf0bcda32b57b277d9ad9f146e");
+    EXPECT_EQ(std::string(hex.data(), hex.size()), SHA256Hex(data));
+    
+    SHA256Hex(nullptr, 0, hex);
+    EXPECT_EQ(std::string(hex.data(), hex.size()),
+              "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+}
+
+// Test Base58Encode against known vectors, including leading zero bytes
+TEST_F(HexUtilsTest, Base58Encode) {
+    std::string text = "Hello World!";
+    EXPECT_EQ(Base58Encode(reinterpret_cast<const uint8_t*>(text.data()), text.size()), "2NEpo7TZRRrLZSi2U");
+    
+    std::vector<uint8_t> zeros = {0x00, 0x00, 0x28, 0x7f, 0xb4, 0xcd};
+    EXPECT_EQ(Base58Encode(zeros.data(), zeros.size()), "11233QC4");
+    
+    EXPECT_EQ(Base58Encode(nullptr, 0), "");
+}
+
 } // namespace optimum_p2p
 